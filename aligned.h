@@ -0,0 +1,75 @@
+/*
+ * @file    aligned.h
+ * @brief   This allocator hands out memory aligned to a cache line, so that
+ *          containers built on it can be read with aligned vector loads and
+ *          rows padded to a multiple of the line size never straddle two
+ *          lines.
+ */
+
+#ifndef _ALIGNED_H
+#define	_ALIGNED_H
+
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+const size_t ALIGNMENT = 64;            // bytes in a cache line
+
+
+template <class Type>
+class AlignedAllocator
+{
+public:
+
+    typedef Type value_type;
+
+    AlignedAllocator() { }
+
+    template <class Other>
+    AlignedAllocator(const AlignedAllocator<Other>&) { }
+
+    /**------------------ allocate() ------------------------------------------
+     * Reserves uninitialized memory for a number of objects.
+     * @param count  The number of objects to make room for.
+     * @pre None.
+     * @post The memory begins on a multiple of ALIGNMENT.
+     * @return A pointer to the memory; throws bad_alloc on failure.
+     */
+    Type* allocate(size_t count)
+    {
+        void* memory = NULL;
+
+        if (posix_memalign(&memory, ALIGNMENT, count * sizeof(Type)) != 0)
+        {
+            throw bad_alloc();
+        } // end if (posix_memalign(...) != 0)
+
+        return static_cast<Type*>(memory);
+    } // end allocate(size_t)
+
+    /**------------------ deallocate() ----------------------------------------
+     * Releases memory obtained from allocate().
+     * @param memory  The memory to release.
+     * @pre memory came from allocate() and holds no live objects.
+     * @post The memory is freed.
+     */
+    void deallocate(Type* memory, size_t)
+    {
+        free(memory);
+    } // end deallocate(Type*, size_t)
+
+}; // end class AlignedAllocator
+
+template <class Type, class Other>
+bool operator==(const AlignedAllocator<Type>&, const AlignedAllocator<Other>&)
+{
+    return true;
+} // end operator==
+
+template <class Type, class Other>
+bool operator!=(const AlignedAllocator<Type>&, const AlignedAllocator<Other>&)
+{
+    return false;
+} // end operator!=
+
+#endif	/* _ALIGNED_H */
@@ -0,0 +1,89 @@
+/*
+ * @file    arena.cpp
+ * @brief   This class hands out memory from large blocks by bumping a pointer,
+ *          so that many small objects are allocated with no per-object
+ *          bookkeeping and are packed next to one another. Objects cannot be
+ *          freed one at a time; every block is released at once when the
+ *          arena is released or destroyed.
+ */
+
+#include <new>
+#include "arena.h"
+
+using namespace std;
+
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an empty arena. No memory is obtained until the first allocation.
+ * @pre None.
+ * @post An empty arena exists.
+ */
+Arena::Arena() : next(NULL), left(0)
+{
+} // end constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Frees every block.
+ * @pre No object in the arena is still in use.
+ * @post All memory is freed.
+ */
+Arena::~Arena()
+{
+    release();
+} // end destructor
+
+/**---------------------- allocate() ------------------------------------------
+ * Reserves uninitialized memory. A new block is started when the newest one
+ * has too little room left; a request larger than ARENABLOCK gets a block of
+ * its own.
+ * @param bytes  The number of bytes to reserve.
+ * @pre None.
+ * @post The memory begins on a multiple of ARENAALIGN and stays valid until
+ *       the arena is released.
+ * @return A pointer to the memory; throws bad_alloc on failure.
+ */
+void* Arena::allocate(size_t bytes)
+{
+    char* memory;
+
+    bytes = (bytes + ARENAALIGN - 1) / ARENAALIGN * ARENAALIGN;
+
+    if (bytes > left)           // newest block is full
+    {
+        size_t blockSize = (bytes > ARENABLOCK ? bytes : ARENABLOCK);
+
+        memory = static_cast<char*>(malloc(blockSize));
+
+        if (memory == NULL)
+        {
+            throw bad_alloc();
+        } // end if (memory == NULL)
+
+        blocks.push_back(memory);
+        next = memory;
+        left = blockSize;
+    } // end if (bytes > left)
+
+    memory = next;
+    next += bytes;
+    left -= bytes;
+
+    return memory;
+} // end allocate(size_t)
+
+/**---------------------- release() -------------------------------------------
+ * Frees every block, invalidating all memory handed out so far.
+ * @pre No object in the arena is still in use.
+ * @post The arena is empty and may be used again.
+ */
+void Arena::release()
+{
+    for (int i = 0; i < (int)blocks.size(); ++i)
+    {
+        free(blocks[i]);
+    } // end for (int i = 0)
+
+    blocks.clear();
+    next = NULL;
+    left = 0;
+} // end release()
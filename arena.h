@@ -0,0 +1,44 @@
+/*
+ * @file    arena.h
+ * @brief   This class hands out memory from large blocks by bumping a pointer,
+ *          so that many small objects are allocated with no per-object
+ *          bookkeeping and are packed next to one another. Objects cannot be
+ *          freed one at a time; every block is released at once when the
+ *          arena is released or destroyed.
+ */
+
+#ifndef _ARENA_H
+#define	_ARENA_H
+
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+const size_t ARENABLOCK = 64 * 1024;    // bytes in a typical block
+const size_t ARENAALIGN = 16;           // alignment of every allocation
+
+
+class Arena
+{
+public:
+
+    Arena();
+
+    virtual ~Arena();
+
+    void* allocate(size_t bytes);
+
+    void release(void);
+
+private:
+
+    vector<char*> blocks;       // every block obtained so far
+    char*         next;         // first free byte in the newest block
+    size_t        left;         // free bytes in the newest block
+
+    Arena(const Arena&);                // blocks cannot be shared
+    Arena& operator=(const Arena&);
+
+}; // end class Arena
+
+#endif	/* _ARENA_H */
@@ -0,0 +1,189 @@
+/*
+ * @file    batch.cpp
+ * @brief   This class pushes a file of many graphs through a pipeline. One
+ *          thread parses graphs in turn, a group of workers find their
+ *          shortest paths and render their reports, and the calling thread
+ *          prints the reports in input order. The output matches what
+ *          building, solving and displaying each graph in turn would print.
+ *          At most a fixed number of graphs are in flight at once, so memory
+ *          stays bounded however long the file is.
+ */
+
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "batch.h"
+
+using namespace std;
+
+
+/**---------------------- Constructor -----------------------------------------
+ * Creates a pipeline with a fixed number of solver threads.
+ * @param threads  The number of solver threads. A value less than one uses
+ *                 one per hardware thread.
+ * @param window  The most graphs that may be parsed but not yet printed. A
+ *                value less than one allows two per solver thread.
+ * @pre None.
+ * @post The pipeline is ready to run.
+ */
+GraphBatch::GraphBatch(int threads, int window) : workers(threads),
+    inFlight(window), read(0), printed(0), ended(false)
+{
+    if (workers < 1)
+    {
+        workers = thread::hardware_concurrency();
+    } // end if (workers < 1)
+
+    if (workers < 1)    // hardware could not be queried
+    {
+        workers = 1;
+    } // end if (workers < 1)
+
+    if (inFlight < 1)
+    {
+        inFlight = 2 * workers;
+    } // end if (inFlight < 1)
+} // end Constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Destroys the pipeline.
+ * @pre No call to run() is in progress.
+ * @post None.
+ */
+GraphBatch::~GraphBatch()
+{
+} // end destructor
+
+/**---------------------- run() -----------------------------------------------
+ * Reads every graph in a file and prints, for each in turn, all of its
+ * shortest paths followed by the path from node 3 to node 1.
+ * @param input  The file of graphs, formatted as for GraphM::buildGraph().
+ * @param output  The stream to which to print.
+ * @pre No other call to run() is in progress.
+ * @post Every graph in input has been reported to output, in input order.
+ */
+void GraphBatch::run(GraphFile& input, ostream& output)
+{
+    vector<thread> solvers;
+    thread         parser;
+    string         report;
+
+    read = printed = 0;
+    ended = false;
+    parser = thread(&GraphBatch::parse, this, ref(input));
+
+    for (int i = 0; i < workers; ++i)
+    {
+        solvers.push_back(thread(&GraphBatch::solve, this));
+    } // end for (int i = 0)
+
+    for (;;)
+    {
+        {
+            unique_lock<mutex> guard(lock);
+
+            while(reports.count(printed) == 0 && !(ended && printed == read))
+            {
+                changed.wait(guard);
+            } // end while(reports.count(printed) == 0 && ...)
+
+            if (reports.count(printed) == 0)    // every graph is printed
+            {
+                break;
+            } // end if (reports.count(printed) == 0)
+
+            report.swap(reports[printed]);
+            reports.erase(printed++);
+        }
+
+        changed.notify_all();           // the parser may read another
+        output << report;
+    } // end for (;;)
+
+    parser.join();
+
+    for (int i = 0; i < workers; ++i)
+    {
+        solvers[i].join();
+    } // end for (int i = 0)
+} // end run(GraphFile&, ostream&)
+
+/**---------------------- parse() ---------------------------------------------
+ * Reads graphs until the end of the input, never letting more than the
+ * window of graphs be in flight.
+ * @param input  The file of graphs.
+ * @pre None.
+ * @post Every graph has been queued for the solvers and ended is set.
+ */
+void GraphBatch::parse(GraphFile& input)
+{
+    for (;;)
+    {
+        GraphM* graph = new GraphM;
+
+        graph->buildGraph(input);
+
+        unique_lock<mutex> guard(lock);
+
+        if (input.eof())
+        {
+            delete graph;
+            ended = true;
+            changed.notify_all();
+            break;
+        } // end if (input.eof())
+
+        while(read - printed >= inFlight)
+        {
+            changed.wait(guard);
+        } // end while(read - printed >= inFlight)
+
+        parsed.push_back(make_pair(read++, graph));
+        changed.notify_all();
+    } // end for (;;)
+} // end parse(GraphFile&)
+
+/**---------------------- solve() ---------------------------------------------
+ * Takes graphs off the queue, finds their shortest paths and renders their
+ * reports, until the parser has ended and the queue is empty.
+ * @pre None.
+ * @post Every graph taken has been reported and freed.
+ */
+void GraphBatch::solve()
+{
+    for (;;)
+    {
+        pair<int, GraphM*> job;
+        ostringstream      report;
+
+        {
+            unique_lock<mutex> guard(lock);
+
+            while(parsed.empty() && !ended)
+            {
+                changed.wait(guard);
+            } // end while(parsed.empty() && !ended)
+
+            if (parsed.empty())     // nothing more will be parsed
+            {
+                break;
+            } // end if (parsed.empty())
+
+            job = parsed.front();
+            parsed.pop_front();
+        }
+
+        job.second->findShortestPath();
+        job.second->displayAll(report);
+        job.second->display(3, 1, report);
+        delete job.second;
+
+        {
+            unique_lock<mutex> guard(lock);
+
+            reports[job.first] = report.str();
+        }
+
+        changed.notify_all();
+    } // end for (;;)
+} // end solve()
@@ -0,0 +1,54 @@
+/*
+ * @file    batch.h
+ * @brief   This class pushes a file of many graphs through a pipeline. One
+ *          thread parses graphs in turn, a group of workers find their
+ *          shortest paths and render their reports, and the calling thread
+ *          prints the reports in input order. The output matches what
+ *          building, solving and displaying each graph in turn would print.
+ *          At most a fixed number of graphs are in flight at once, so memory
+ *          stays bounded however long the file is.
+ */
+
+#ifndef _BATCH_H
+#define	_BATCH_H
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include "graphfile.h"
+#include "graphm.h"
+
+using namespace std;
+
+
+class GraphBatch
+{
+public:
+
+    GraphBatch(int threads, int window);
+
+    virtual ~GraphBatch();
+
+    void run(GraphFile& input, ostream& output);
+
+private:
+
+    int                      workers;   // solver threads
+    int                      inFlight;  // most graphs parsed, not printed
+    mutex                    lock;      // guards everything below
+    condition_variable       changed;   // signaled on any change below
+    deque<pair<int, GraphM*> > parsed;  // graphs waiting for a worker
+    map<int, string>         reports;   // finished, waiting to be printed
+    int                      read;      // graphs parsed so far
+    int                      printed;   // reports printed so far
+    bool                     ended;     // the parser found the end of input
+
+    void parse(GraphFile& input);
+
+    void solve(void);
+
+}; // end class GraphBatch
+
+#endif	/* _BATCH_H */
@@ -0,0 +1,719 @@
+//---------------------------------------------------------------------------
+// bench.cpp
+//---------------------------------------------------------------------------
+// Benchmarks GraphM and GraphL on seeded synthetic graphs. There are six
+// modes:
+//
+//   bench [suite [maxNodes]]
+//      Times each operation separately on random sparse, dense, grid
+//      (road-like) and chain graphs of 10 to maxNodes nodes (default
+//      1000000). Each line of output describes one operation:
+//
+//      op=<name> class=<GraphM|GraphL> gen=<name> nodes=<n> edges=<e>
+//         ops=<count> ns_per_op=<t> ops_per_sec=<r> peak_rss_kb=<k>
+//
+//      (printed on one line). build counts one op per edge read,
+//      findShortestPath, table and rankedTable one per node pair, display,
+//      query and route one per query, preprocess one per node and dfs one
+//      per node visited. table times distanceTable() from TABLEORIGINS
+//      random origins to TABLETARGETS random targets, before any paths are
+//      found. query times queryPath(), which finds one pair's path without
+//      the path matrix; preprocess times buildHierarchy(), also before any
+//      paths are found, and route times routePath() on the hierarchy it
+//      builds, whose size follows on a line of its own:
+//
+//      index class=GraphM gen=<name> nodes=<n> shortcuts=<s> bytes=<b>
+//
+//      rankedTable times the same table again once the hierarchy is built,
+//      which finds it through the hierarchy. Dense graphs of more than
+//      DENSERANKMAX nodes, which a hierarchy does not suit, skip these three.
+//
+//      peak_rss_kb is the peak for the whole process so far. When built with
+//      -DGRAPH_STATS, each graph is followed by
+//
+//      stats class=<GraphM|GraphL> gen=<name> nodes=<n> <json>
+//
+//      holding the hot path counters of that graph, as PathStats writes them.
+//
+//   bench engines
+//      Times the shortest path engines of GraphM on random graphs of
+//      several sizes and densities, so the point where one engine
+//      overtakes another can be found. Each line of output is:
+//
+//      engine=<name> nodes=<n> density=<d> edges=<e> ms=<time>
+//
+//   bench readers
+//      Times lock-free queries on a SharedGraph from 1 to 8 reader threads,
+//      first alone and then while a writer publishes edge changes as fast as
+//      it can. Each line of output is:
+//
+//      op=read class=SharedGraph gen=sparse nodes=<n> readers=<r>
+//         writer=<off|on> ops=<count> ns_per_op=<t> ops_per_sec=<r>
+//         publishes=<p>
+//
+//      (printed on one line). ns_per_op is the mean latency seen by one
+//      reader; ops_per_sec is the total over all readers.
+//
+//   bench orders
+//      Times GraphM path finding and GraphL depth-first search on grid and
+//      sparse graphs whose node numbers have been shuffled, after reorder()
+//      with each node order, and the reordering itself. Each line of output
+//      is:
+//
+//      op=<name> class=<GraphM|GraphL> gen=<name> order=<name> nodes=<n>
+//         ms=<time>
+//
+//      (printed on one line). query times QUERIES calls to queryPath().
+//
+//   bench paths [nodes]
+//      Writes the shortest paths between all pairs of a grid graph of nodes
+//      nodes (default PATHNODES) to a PathFile, narrowed, without building
+//      a GraphM, then times random distance and path reads from the file.
+//      Each line of output is:
+//
+//      op=<write|distance|path> class=PathFile gen=grid nodes=<n>
+//         ops=<count> ns_per_op=<t> file_kb=<f> peak_rss_kb=<k>
+//         anon_kb=<a>
+//
+//      (printed on one line). write counts one op per node pair. file_kb
+//      is the size of the file, and anon_kb the memory of the process not
+//      backed by a file. peak_rss_kb also counts pages of the file mapped
+//      in by reads; the system drops those again as it needs room.
+//
+// Assumptions:
+//   -- graphs are passed to buildGraph through the file "bench-<pid>.tmp",
+//      and paths mode writes "bench-<pid>.apt", both in the directory named
+//      by BENCHDIR, or else TMPDIR, or else /tmp; both are removed when
+//      bench exits, or is stopped by SIGHUP, SIGINT, SIGPIPE or SIGTERM
+//   -- GraphM keeps three node-by-node matrixes, so it is only run on
+//      graphs of up to MATRIXMAX nodes; dense graphs are only generated
+//      up to DENSEMAX nodes
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include "graphl.h"
+#include "graphm.h"
+#include "pathfile.h"
+#include "sharedgraph.h"
+using namespace std;
+
+string      benchName;                 // scratch graph file, and the
+string      pathsName;                 //  path file of paths mode
+const char* BENCHFILE = NULL;          // their names, once chosen by
+const char* PATHSFILE = NULL;          //  scratchFiles()
+const int   MATRIXMAX = 1000;          // largest graph given to GraphM
+const int   DENSEMAX  = 1000;          // largest dense graph generated
+const int   DENSERANKMAX = 100;        // largest dense graph preprocessed
+const int   QUERIES   = 1000;          // display queries timed per graph
+const int   TABLEORIGINS = 50;         // rows of the distance table timed
+const int   TABLETARGETS = 500;        //  and its columns
+const int   ORDERMAX  = 1000000;       // nodes given to GraphL by orders
+const int   SHAREDMAX = 500;           // nodes in the SharedGraph benchmark
+const int   READMS    = 200;           // milliseconds each reader run lasts
+const int   PATHNODES = 10000;         // nodes given to PathFile by paths
+
+enum Generator { SPARSE, DENSE, GRID, CHAIN };
+const char* GENNAMES[] = { "sparse", "dense", "grid", "chain" };
+
+// discards everything written to it, so printing can be timed alone
+class NullBuffer : public streambuf {
+protected:
+   int overflow(int c) { return c; }
+   streamsize xsputn(const char*, streamsize count) { return count; }
+};
+
+typedef chrono::steady_clock Clock;
+
+// milliseconds since start
+static double since(Clock::time_point start) {
+   chrono::duration<double, milli> elapsed = Clock::now() - start;
+   return elapsed.count();
+}
+
+// peak resident set size of this process so far, in kilobytes
+static long peakRss() {
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+   return usage.ru_maxrss;
+}
+
+// writes one edge line; GraphL input has no cost column
+static void writeEdge(ofstream& out, int v, int w, int cost, bool costs) {
+   out << v << ' ' << w;
+   if (costs)
+      out << ' ' << cost;
+   out << '\n';
+}
+
+// writes a graph in the input format of buildGraph and returns its edge
+// count; sparse graphs have four random out-edges per node, dense graphs
+// each possible edge with probability one half, grids edges both ways
+// between lattice neighbors and chains an edge from each node to the next
+static long writeSynthetic(Generator gen, int nodes, unsigned seed,
+                           bool costs) {
+   mt19937 random(seed);
+   uniform_int_distribution<int> node(1, nodes);
+   uniform_int_distribution<int> cost(1, 100);
+   ofstream out(BENCHFILE);
+   long edges = 0;
+
+   out << nodes << '\n';
+   for (int i = 1; i <= nodes; ++i)
+      out << "node " << i << '\n';
+
+   if (gen == SPARSE) {
+      for (int v = 1; v <= nodes; ++v)
+         for (int k = 0; k < 4 && nodes > 1; ++k) {
+            int w = node(random);
+            if (w != v) {
+               writeEdge(out, v, w, cost(random), costs);
+               ++edges;
+            }
+         }
+   }
+   else if (gen == DENSE) {
+      for (int v = 1; v <= nodes; ++v)
+         for (int w = 1; w <= nodes; ++w)
+            if (v != w && (random() & 1)) {
+               writeEdge(out, v, w, cost(random), costs);
+               ++edges;
+            }
+   }
+   else if (gen == GRID) {
+      int side = 1;
+      while ((side + 1) * (side + 1) <= nodes)
+         ++side;
+      for (int v = 1; v <= nodes; ++v) {
+         int row = (v - 1) / side, col = (v - 1) % side;
+         int next[] = { col + 1 < side && v < nodes ? v + 1 : 0,
+                        col > 0 ? v - 1 : 0,
+                        v + side <= nodes ? v + side : 0,
+                        row > 0 ? v - side : 0 };
+         for (int k = 0; k < 4; ++k)
+            if (next[k] != 0) {
+               writeEdge(out, v, next[k], cost(random) % 9 + 1, costs);
+               ++edges;
+            }
+      }
+   }
+   else {
+      for (int v = 1; v < nodes; ++v) {
+         writeEdge(out, v, v + 1, cost(random), costs);
+         ++edges;
+      }
+   }
+
+   out << (costs ? "0 0 0\n" : "0 0\n");
+   return edges;
+}
+
+// prints one result line in the suite format
+static void report(const char* op, const char* type, Generator gen,
+                   int nodes, long edges, double count, double ms) {
+   double ns = (count > 0 ? ms * 1e6 / count : 0.0);
+   cout << "op=" << op << " class=" << type << " gen=" << GENNAMES[gen]
+        << " nodes=" << nodes << " edges=" << edges
+        << " ops=" << (long long)count << " ns_per_op=" << ns
+        << " ops_per_sec=" << (ns > 0 ? 1e9 / ns : 0.0)
+        << " peak_rss_kb=" << peakRss() << endl;
+}
+
+// prints the counters of one graph, if they were compiled in
+static void reportStats(const char* type, Generator gen, int nodes,
+                        const PathStats& stats) {
+   if (STATSENABLED) {
+      cout << "stats class=" << type << " gen=" << GENNAMES[gen]
+           << " nodes=" << nodes << ' ';
+      stats.writeJson(cout);
+      cout << endl;
+   }
+}
+
+// times building, finding all shortest paths, display queries and the
+// point-to-point queries on GraphM
+static void benchMatrix(Generator gen, int nodes, unsigned seed) {
+   long edges = writeSynthetic(gen, nodes, seed, true);
+   NullBuffer discard;
+   ostream sink(&discard);
+   mt19937 random(seed);
+   uniform_int_distribution<int> node(1, nodes);
+   GraphFile in(BENCHFILE);
+   GraphM G;
+
+   Clock::time_point start = Clock::now();
+   G.buildGraph(in);
+   report("build", "GraphM", gen, nodes, edges, edges, since(start));
+
+   vector<int> origins, targets, table;
+   for (int k = 0; k < min(nodes, TABLEORIGINS); ++k)
+      origins.push_back(node(random));
+   for (int k = 0; k < min(nodes, TABLETARGETS); ++k)
+      targets.push_back(node(random));
+   start = Clock::now();
+   G.distanceTable(origins, targets, table);
+   report("table", "GraphM", gen, nodes, edges,
+          (double)origins.size() * targets.size(), since(start));
+
+   bool ranked = (gen != DENSE || nodes <= DENSERANKMAX);
+   if (ranked) {
+      start = Clock::now();
+      G.buildHierarchy();
+      report("preprocess", "GraphM", gen, nodes, edges, nodes, since(start));
+      cout << "index class=GraphM gen=" << GENNAMES[gen] << " nodes=" << nodes
+           << " shortcuts=" << G.hierarchy().shortcuts()
+           << " bytes=" << G.hierarchy().bytes() << endl;
+
+      start = Clock::now();
+      G.distanceTable(origins, targets, table);
+      report("rankedTable", "GraphM", gen, nodes, edges,
+             (double)origins.size() * targets.size(), since(start));
+   }
+
+   start = Clock::now();
+   G.findShortestPath();
+   report("findShortestPath", "GraphM", gen, nodes, edges,
+          (double)nodes * nodes, since(start));
+
+   start = Clock::now();
+   for (int q = 0; q < QUERIES; ++q)
+      G.display(node(random), node(random), sink);
+   report("display", "GraphM", gen, nodes, edges, QUERIES, since(start));
+
+   vector<int> path;
+   start = Clock::now();
+   for (int q = 0; q < QUERIES; ++q)
+      G.queryPath(node(random), node(random), path);
+   report("query", "GraphM", gen, nodes, edges, QUERIES, since(start));
+
+   if (ranked) {
+      start = Clock::now();
+      for (int q = 0; q < QUERIES; ++q)
+         G.routePath(node(random), node(random), path);
+      report("route", "GraphM", gen, nodes, edges, QUERIES, since(start));
+   }
+   reportStats("GraphM", gen, nodes, G.stats());
+}
+
+// times building and depth-first search on GraphL
+static void benchList(Generator gen, int nodes, unsigned seed) {
+   long edges = writeSynthetic(gen, nodes, seed, false);
+   GraphFile in(BENCHFILE);
+   GraphL G;
+
+   Clock::time_point start = Clock::now();
+   G.buildGraph(in);
+   report("build", "GraphL", gen, nodes, edges, edges, since(start));
+
+   start = Clock::now();
+   vector<int> order = G.depthFirstOrder();
+   report("dfs", "GraphL", gen, nodes, edges, order.size(), since(start));
+   reportStats("GraphL", gen, nodes, G.stats());
+}
+
+// runs every operation on every generator at each power of ten
+static void runSuite(int maxNodes) {
+   for (int nodes = 10; nodes <= maxNodes; nodes *= 10) {
+      for (int g = SPARSE; g <= CHAIN; ++g) {
+         Generator gen = (Generator)g;
+         unsigned seed = 343 + nodes + g;
+         if (gen == DENSE && nodes > DENSEMAX)
+            continue;
+         if (nodes <= MATRIXMAX)
+            benchMatrix(gen, nodes, seed);
+         benchList(gen, nodes, seed);
+      }
+   }
+}
+
+// writes a synthetic graph as writeSynthetic does, then renumbers its nodes
+// at random, so nodes joined by edges no longer have nearby numbers
+static void writeShuffled(Generator gen, int nodes, unsigned seed,
+                          bool costs) {
+   vector<int> number(nodes + 1);
+   vector<int> from, to, cost;
+   int v, w, c = 0;
+
+   writeSynthetic(gen, nodes, seed, costs);
+   ifstream in(BENCHFILE);
+   in >> v;
+   in.ignore();
+   for (int i = 0; i < nodes; ++i)
+      in.ignore(numeric_limits<streamsize>::max(), '\n');
+   while (in >> v >> w && v != 0) {
+      if (costs)
+         in >> c;
+      from.push_back(v);
+      to.push_back(w);
+      cost.push_back(c);
+   }
+   in.close();
+
+   mt19937 random(seed);
+   for (int i = 0; i <= nodes; ++i)
+      number[i] = i;
+   shuffle(number.begin() + 1, number.end(), random);
+
+   ofstream out(BENCHFILE);
+   out << nodes << '\n';
+   for (int i = 1; i <= nodes; ++i)
+      out << "node " << i << '\n';
+   for (size_t e = 0; e < from.size(); ++e)
+      writeEdge(out, number[from[e]], number[to[e]], cost[e], costs);
+   out << (costs ? "0 0 0\n" : "0 0\n");
+}
+
+// times path finding on GraphM and depth-first search on GraphL under each
+// node order, on shuffled grid and sparse graphs
+static void runOrders() {
+   const NodeOrder orders[] = { INPUT_ORDER, BFS_ORDER, RCM_ORDER,
+                                DEGREE_ORDER };
+   const char* names[] = { "input", "bfs", "rcm", "degree" };
+   const Generator gens[] = { GRID, SPARSE };
+
+   for (int g = 0; g < 2; ++g) {
+      writeShuffled(gens[g], MATRIXMAX, 343 + g, true);
+      for (int o = 0; o < 4; ++o) {
+         GraphFile in(BENCHFILE);
+         GraphM G;
+         mt19937 random(343);
+         uniform_int_distribution<int> node(1, MATRIXMAX);
+         vector<int> path;
+         G.buildGraph(in);
+
+         Clock::time_point start = Clock::now();
+         G.reorder(orders[o]);
+         double ms = since(start);
+         cout << "op=reorder class=GraphM gen=" << GENNAMES[gens[g]]
+              << " order=" << names[o] << " nodes=" << MATRIXMAX
+              << " ms=" << ms << endl;
+
+         start = Clock::now();
+         G.findShortestPath();
+         ms = since(start);
+         cout << "op=findShortestPath class=GraphM gen=" << GENNAMES[gens[g]]
+              << " order=" << names[o] << " nodes=" << MATRIXMAX
+              << " ms=" << ms << endl;
+
+         start = Clock::now();
+         for (int q = 0; q < QUERIES; ++q)
+            G.queryPath(node(random), node(random), path);
+         ms = since(start);
+         cout << "op=query class=GraphM gen=" << GENNAMES[gens[g]]
+              << " order=" << names[o] << " nodes=" << MATRIXMAX
+              << " ms=" << ms << endl;
+      }
+
+      writeShuffled(gens[g], ORDERMAX, 343 + g, false);
+      for (int o = 0; o < 4; ++o) {
+         GraphFile in(BENCHFILE);
+         GraphL G;
+         G.buildGraph(in);
+
+         Clock::time_point start = Clock::now();
+         G.reorder(orders[o]);
+         double ms = since(start);
+         cout << "op=reorder class=GraphL gen=" << GENNAMES[gens[g]]
+              << " order=" << names[o] << " nodes=" << ORDERMAX
+              << " ms=" << ms << endl;
+
+         start = Clock::now();
+         vector<int> order = G.depthFirstOrder();
+         ms = since(start);
+         cout << "op=dfs class=GraphL gen=" << GENNAMES[gens[g]]
+              << " order=" << names[o] << " nodes=" << ORDERMAX
+              << " ms=" << ms << endl;
+      }
+   }
+}
+
+// writes a graph in the input format of buildGraph; each possible edge is
+// present with probability density and costs 1 to 100
+static int writeGraph(int nodes, double density, unsigned seed) {
+   mt19937 random(seed);
+   uniform_real_distribution<double> coin(0.0, 1.0);
+   uniform_int_distribution<int> cost(1, 100);
+   ofstream out(BENCHFILE);
+   int edges = 0;
+
+   out << nodes << '\n';
+   for (int i = 1; i <= nodes; ++i)
+      out << "node " << i << '\n';
+   for (int v = 1; v <= nodes; ++v)
+      for (int w = 1; w <= nodes; ++w)
+         if (v != w && coin(random) < density) {
+            out << v << ' ' << w << ' ' << cost(random) << '\n';
+            ++edges;
+         }
+   out << "0 0 0\n";
+   return edges;
+}
+
+// builds the graph in BENCHFILE and times findShortestPath with one engine
+static double timeEngine(PathEngine engine) {
+   ifstream in(BENCHFILE);
+   GraphM G;
+   G.buildGraph(in);
+   G.setEngine(engine);
+   Clock::time_point start = Clock::now();
+   G.findShortestPath();
+   return since(start);
+}
+
+// compares the shortest path engines over a range of sizes and densities
+static void runEngines() {
+   const int    sizes[]     = { 64, 128, 256, 512, 1024 };
+   const double densities[] = { 0.01, 0.05, 0.1, 0.25, 0.5, 1.0 };
+   const PathEngine engines[] = { MATRIX_SCAN, BINARY_HEAP, BUCKET_QUEUE,
+                                  FLOYD_WARSHALL, AUTO_ENGINE };
+   const char* names[] = { "scan", "heap", "bucket", "floyd", "auto" };
+
+   for (int s = 0; s < 5; ++s) {
+      for (int d = 0; d < 6; ++d) {
+         int edges = writeGraph(sizes[s], densities[d], 343 + s * 6 + d);
+         for (int e = 0; e < 5; ++e) {
+            cout << "engine=" << names[e] << " nodes=" << sizes[s]
+                 << " density=" << densities[d] << " edges=" << edges
+                 << " ms=" << timeEngine(engines[e]) << endl;
+         }
+      }
+   }
+}
+
+// runs readers on a shared graph for READMS, with or without a writer
+// publishing random cost changes, and reports their query rate
+static void timeReaders(SharedGraph& shared, int readers, bool writing) {
+   atomic<bool>  stop(false);
+   atomic<long>  reads(0), publishes(0);
+   vector<thread> workers;
+
+   for (int r = 0; r < readers; ++r) {
+      workers.push_back(thread([&, r]() {
+         mt19937 random(343 + r);
+         uniform_int_distribution<int> node(1, SHAREDMAX);
+         vector<int> path;
+         int slot = shared.join();
+         long count = 0;
+         if (slot < 0) {
+            cerr << "no reader slot left for reader " << r << endl;
+            return;
+         }
+         while (!stop) {
+            shared.path(slot, node(random), node(random), path);
+            ++count;
+         }
+         shared.leave(slot);
+         reads += count;
+      }));
+   }
+   if (writing) {
+      workers.push_back(thread([&]() {
+         mt19937 random(343);
+         uniform_int_distribution<int> node(1, SHAREDMAX);
+         uniform_int_distribution<int> cost(1, 100);
+         while (!stop) {
+            for (int k = 0; k < 4; ++k)
+               shared.insertEdge(node(random), node(random), cost(random));
+            shared.publish();
+            ++publishes;
+         }
+      }));
+   }
+
+   this_thread::sleep_for(chrono::milliseconds(READMS));
+   stop = true;
+   for (int t = 0; t < (int)workers.size(); ++t)
+      workers[t].join();
+
+   double ns = READMS * 1e6 * readers / reads;
+   cout << "op=read class=SharedGraph gen=sparse nodes=" << SHAREDMAX
+        << " readers=" << readers << " writer=" << (writing ? "on" : "off")
+        << " ops=" << reads << " ns_per_op=" << ns
+        << " ops_per_sec=" << reads * 1000.0 / READMS
+        << " publishes=" << publishes << endl;
+}
+
+// compares query rates on a shared graph by reader count and write load
+static void runReaders() {
+   writeSynthetic(SPARSE, SHAREDMAX, 343, true);
+   GraphFile   in(BENCHFILE);
+   GraphM      G;
+   SharedGraph shared(8);
+
+   G.buildGraph(in);
+   shared.load(G);
+   for (int readers = 1; readers <= 8; readers *= 2) {
+      timeReaders(shared, readers, false);
+      timeReaders(shared, readers, true);
+   }
+}
+
+// reads the edges of BENCHFILE into out-edge lists, each list in order of
+// destination, as PathFile::write takes them
+static void readEdges(int& nodes, vector<int>& start, vector<int>& dest,
+                      vector<int>& cost) {
+   vector<int> from, to, weight;
+   int v, w, c;
+
+   ifstream in(BENCHFILE);
+   in >> nodes;
+   in.ignore();
+   for (int i = 0; i < nodes; ++i)
+      in.ignore(numeric_limits<streamsize>::max(), '\n');
+   while (in >> v >> w >> c && v != 0) {
+      from.push_back(v);
+      to.push_back(w);
+      weight.push_back(c);
+   }
+
+   vector<size_t> order(from.size());
+   for (size_t e = 0; e < order.size(); ++e)
+      order[e] = e;
+   sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return make_pair(from[a], to[a]) < make_pair(from[b], to[b]);
+   });
+
+   start.assign(nodes + 2, 0);
+   dest.clear();
+   cost.clear();
+   for (size_t k = 0; k < order.size(); ++k) {
+      ++start[from[order[k]] + 1];
+      dest.push_back(to[order[k]]);
+      cost.push_back(weight[order[k]]);
+   }
+   for (int i = 1; i <= nodes + 1; ++i)
+      start[i] += start[i - 1];
+}
+
+// resident memory of this process not backed by a file, in kilobytes
+static long anonRss() {
+   ifstream status("/proc/self/status");
+   string line;
+   while (getline(status, line))
+      if (line.compare(0, 8, "RssAnon:") == 0)
+         return atol(line.c_str() + 8);
+   return 0;
+}
+
+// prints one result line in the paths format
+static void reportPaths(const char* op, int nodes, double count, double ms) {
+   struct stat info;
+   double ns = (count > 0 ? ms * 1e6 / count : 0.0);
+   long kb = (stat(PATHSFILE, &info) == 0 ? (long)(info.st_size / 1024) : 0);
+   cout << "op=" << op << " class=PathFile gen=grid nodes=" << nodes
+        << " ops=" << (long long)count << " ns_per_op=" << ns
+        << " file_kb=" << kb << " peak_rss_kb=" << peakRss()
+        << " anon_kb=" << anonRss() << endl;
+}
+
+// writes all pairs of a grid graph to a path file and times reads from it
+static void runPaths(int nodes) {
+   vector<int> start, dest, cost, path;
+   PathFile file;
+
+   writeSynthetic(GRID, nodes, 343, true);
+   readEdges(nodes, start, dest, cost);
+
+   Clock::time_point begin = Clock::now();
+   PathFile::write(PATHSFILE, nodes, start, dest, cost, true,
+                   max(1, (int)thread::hardware_concurrency()));
+   reportPaths("write", nodes, (double)nodes * nodes, since(begin));
+
+   if (!file.open(PATHSFILE)) {
+      cerr << "cannot open " << PATHSFILE << endl;
+      return;
+   }
+
+   mt19937 random(343);
+   uniform_int_distribution<int> node(1, nodes);
+   long long sum = 0;
+   begin = Clock::now();
+   for (int q = 0; q < QUERIES; ++q)
+      sum += file.distance(node(random), node(random));
+   reportPaths("distance", nodes, QUERIES, since(begin));
+
+   begin = Clock::now();
+   for (int q = 0; q < QUERIES; ++q)
+      sum += file.path(node(random), node(random), path);
+   reportPaths("path", nodes, QUERIES, since(begin));
+
+   if (sum == 0)
+      cerr << "no paths found" << endl;
+   file.close();
+   remove(PATHSFILE);
+}
+
+// removes the scratch files; only calls unlink, so a signal handler may use it
+static void removeScratch() {
+   if (BENCHFILE != NULL)
+      unlink(BENCHFILE);
+   if (PATHSFILE != NULL)
+      unlink(PATHSFILE);
+}
+
+// removes the scratch files and ends bench when it is interrupted
+static void stopped(int sig) {
+   removeScratch();
+   _exit(128 + sig);
+}
+
+// names the scratch files in BENCHDIR, TMPDIR or /tmp, after this process so
+// runs side by side do not clash, and arranges for them to be removed
+static void scratchFiles() {
+   const char* dir = getenv("BENCHDIR");
+   if (dir == NULL || *dir == '\0')
+      dir = getenv("TMPDIR");
+   if (dir == NULL || *dir == '\0')
+      dir = "/tmp";
+   string prefix = string(dir) + "/bench-" + to_string((long)getpid());
+   benchName = prefix + ".tmp";
+   pathsName = prefix + ".apt";
+   BENCHFILE = benchName.c_str();
+   PATHSFILE = pathsName.c_str();
+   atexit(removeScratch);
+   signal(SIGHUP, stopped);
+   signal(SIGINT, stopped);
+   signal(SIGPIPE, stopped);
+   signal(SIGTERM, stopped);
+}
+
+int main(int argc, char* argv[]) {
+   scratchFiles();
+   if (argc >= 2 && strcmp(argv[1], "engines") == 0) {
+      runEngines();
+   }
+   else if (argc >= 2 && strcmp(argv[1], "readers") == 0) {
+      runReaders();
+   }
+   else if (argc >= 2 && strcmp(argv[1], "orders") == 0) {
+      runOrders();
+   }
+   else if (argc >= 2 && strcmp(argv[1], "paths") == 0) {
+      runPaths(argc >= 3 ? atoi(argv[2]) : PATHNODES);
+   }
+   else if (argc == 1 || strcmp(argv[1], "suite") == 0) {
+      runSuite(argc >= 3 ? atoi(argv[2]) : 1000000);
+   }
+   else {
+      cerr << "Usage: " << argv[0]
+           << " [suite [maxNodes] | engines | readers | orders |"
+           << " paths [nodes]]" << endl;
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * @file    dijkstra.h
+ * @brief   This routine finds the shortest paths from one node over out-edge
+ *          lists with Dijkstra's algorithm and a binary heap of (distance,
+ *          node) pairs. GraphM's heap engine, its distance tables and
+ *          PathFile all search with it, so they all find the same paths:
+ *          ties in the heap go to the lower numbered node, and a path is
+ *          replaced only by a strictly shorter one.
+ */
+
+#ifndef _DIJKSTRA_H
+#define	_DIJKSTRA_H
+
+#include <climits>
+#include <functional>
+#include <queue>
+#include <stdint.h>
+#include <vector>
+#include "pathstats.h"
+
+using namespace std;
+
+
+/**---------------------- dijkstra() ------------------------------------------
+ * Finds the shortest paths from a single node. A node whose distance no
+ * longer matches its heap entry is stale and skipped.
+ * @param source  The node from which to find paths.
+ * @param start  The first out-edge of each node, with start[v + 1] one past
+ *               the last edge of v.
+ * @param dest  The node each edge enters.
+ * @param cost  The cost of each edge; all are positive.
+ * @param dist  Receives the length of the path to each node reached.
+ * @param prev  Receives the node before each node reached on its path.
+ * @param touched  Receives each node reached, so the caller can reset just
+ *                 those entries; NULL if not wanted.
+ * @param settle  Called with each node as its distance becomes final;
+ *                returns false to stop the search there.
+ * @param settled  Counts the nodes settled, with GRAPH_STATS.
+ * @param shortened  Counts the paths shortened, with GRAPH_STATS.
+ * @pre Every entry of dist is INT_MAX and every entry of prev is 0.
+ * @post dist and prev hold the shortest paths from source to every node
+ *       settled; the search stopped early only if settle said so.
+ */
+template <class Settle>
+void dijkstra(int source, const int* start, const int* dest, const int* cost,
+              int* dist, int* prev, vector<int>* touched, Settle settle,
+              uint64_t& settled, uint64_t& shortened)
+{
+    priority_queue<pair<int, int>, vector<pair<int, int> >,
+                   greater<pair<int, int> > > heap;     // (dist, node) pairs
+    int v, w, length;
+
+    dist[source] = 0;
+    heap.push(make_pair(0, source));
+
+    if (touched != NULL)
+    {
+        touched->push_back(source);
+    } // end if (touched != NULL)
+
+    while(!heap.empty())
+    {
+        v = heap.top().second;
+        length = heap.top().first;
+        heap.pop();
+
+        if (length != dist[v])      // skip entries made stale by relaxation
+        {
+            continue;
+        } // end if (length != dist[v])
+
+        STATS_ADD(settled, 1);
+
+        if (!settle(v))
+        {
+            break;
+        } // end if (!settle(v))
+
+        for (int e = start[v]; e < start[v + 1]; ++e)
+        {
+            w = dest[e];
+
+            if (dist[w] > length + cost[e])
+            {
+                if (touched != NULL && dist[w] == INT_MAX)
+                {
+                    touched->push_back(w);
+                } // end if (touched != NULL && ...)
+
+                dist[w] = length + cost[e];
+                prev[w] = v;
+                heap.push(make_pair(dist[w], w));
+                STATS_ADD(shortened, 1);
+            } // end if (dist[w] > length + cost[e])
+        } // end for (int e = start[v])
+    } // end while(!heap.empty())
+
+    (void)settled;                  // counted only with GRAPH_STATS
+    (void)shortened;
+} // end dijkstra(int, const int*, const int*, const int*, ...)
+
+#endif	/* _DIJKSTRA_H */
@@ -0,0 +1,318 @@
+/*
+ * @file    floyd.cpp
+ * @brief   These routines find the shortest paths between all pairs of nodes
+ *          with the Floyd-Warshall algorithm. The distance matrix is split
+ *          into square tiles that fit in cache, and the inner min-plus loop
+ *          runs eight lanes at a time with AVX2 when the processor supports
+ *          it, falling back to a plain loop otherwise. Matrixes are indexed
+ *          from 0 and padded so each row holds a whole number of tiles.
+ */
+
+#include <algorithm>
+#include "floyd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FLOYD_AVX2      // AVX2 kernels are compiled and chosen at run time
+#endif
+
+using namespace std;
+
+
+/**---------------------- relaxTile() -----------------------------------------
+ * Shortens the paths in one tile of the distance matrix using the nodes of
+ * another tile as intermediate stops. Rows whose distance to the stop is
+ * infinite cannot improve and are skipped.
+ * @param dist  The padded distance matrix.
+ * @param stride  The length of a padded row.
+ * @param ib  The first row of the tile to update.
+ * @param jb  The first column of the tile to update.
+ * @param kb  The first of the intermediate nodes.
+ * @pre All tiles lie within the padded matrix.
+ * @post Every dist[i][j] in the tile is no longer than dist[i][k] +
+ *       dist[k][j] for each intermediate k.
+ */
+static void relaxTile(int* dist, int stride, int ib, int jb, int kb)
+{
+    for (int k = kb; k < kb + FLOYDTILE; ++k)
+    {
+        const int* rowK = dist + (size_t)k * stride + jb;
+
+        for (int i = ib; i < ib + FLOYDTILE; ++i)
+        {
+            int* rowI = dist + (size_t)i * stride;
+            int  dik  = rowI[k];
+
+            if (dik < FLOYDINF)
+            {
+                rowI += jb;
+
+                for (int j = 0; j < FLOYDTILE; ++j)
+                {
+                    rowI[j] = min(rowI[j], dik + rowK[j]);
+                } // end for (int j = 0)
+            } // end if (dik < FLOYDINF)
+        } // end for (int i = ib)
+    } // end for (int k = kb)
+} // end relaxTile(int*, int, int, int, int)
+
+#ifdef FLOYD_AVX2
+/**---------------------- relaxTileAvx2() -------------------------------------
+ * Does the same work as relaxTile() eight columns at a time.
+ * @param dist  The padded distance matrix.
+ * @param stride  The length of a padded row.
+ * @param ib  The first row of the tile to update.
+ * @param jb  The first column of the tile to update.
+ * @param kb  The first of the intermediate nodes.
+ * @pre The processor supports AVX2. All tiles lie within the padded matrix.
+ * @post As for relaxTile().
+ */
+__attribute__((target("avx2")))
+static void relaxTileAvx2(int* dist, int stride, int ib, int jb, int kb)
+{
+    for (int k = kb; k < kb + FLOYDTILE; ++k)
+    {
+        const int* rowK = dist + (size_t)k * stride + jb;
+
+        for (int i = ib; i < ib + FLOYDTILE; ++i)
+        {
+            int* rowI = dist + (size_t)i * stride;
+            int  dik  = rowI[k];
+
+            if (dik < FLOYDINF)
+            {
+                __m256i viaK = _mm256_set1_epi32(dik);
+
+                rowI += jb;
+
+                for (int j = 0; j < FLOYDTILE; j += 8)
+                {
+                    __m256i dij, dkj;
+
+                    dij = _mm256_loadu_si256((const __m256i*)(rowI + j));
+                    dkj = _mm256_loadu_si256((const __m256i*)(rowK + j));
+
+                    dij = _mm256_min_epi32(dij, _mm256_add_epi32(viaK, dkj));
+                    _mm256_storeu_si256((__m256i*)(rowI + j), dij);
+                } // end for (int j = 0)
+            } // end if (dik < FLOYDINF)
+        } // end for (int i = ib)
+    } // end for (int k = kb)
+} // end relaxTileAvx2(int*, int, int, int, int)
+#endif
+
+/**---------------------- settleRow() -----------------------------------------
+ * Makes one node the previous node of every node it reaches at exactly the
+ * shortest distance that has no previous node yet.
+ * @param rowS  The distances from the source.
+ * @param rowV  The edge costs from the node.
+ * @param v  The node, counting from 0.
+ * @param stride  The padded row length.
+ * @param path  The previous nodes found so far; -1 where none is found yet.
+ * @pre rowS[v] is less than FLOYDINF.
+ * @post Every node reached by v as described has v + 1 as its previous node.
+ * @return The number of nodes that were given a previous node.
+ */
+static int settleRow(const int* rowS, const int* rowV, int v, int stride,
+                     int* path)
+{
+    int distV = rowS[v], settled = 0;
+
+    for (int w = 0; w < stride; ++w)
+    {
+        int hit = (path[w] == -1) & (distV + rowV[w] == rowS[w]);
+
+        path[w] = hit ? v + 1 : path[w];
+        settled += hit;
+    } // end for (int w = 0)
+
+    return settled;
+} // end settleRow(const int*, const int*, int, int, int*)
+
+#ifdef FLOYD_AVX2
+/**---------------------- settleRowAvx2() -------------------------------------
+ * Does the same work as settleRow() eight nodes at a time.
+ * @param rowS  The distances from the source.
+ * @param rowV  The edge costs from the node.
+ * @param v  The node, counting from 0.
+ * @param stride  The padded row length.
+ * @param path  The previous nodes found so far; -1 where none is found yet.
+ * @pre The processor supports AVX2. rowS[v] is less than FLOYDINF.
+ * @post As for settleRow().
+ * @return The number of nodes that were given a previous node.
+ */
+__attribute__((target("avx2,popcnt")))
+static int settleRowAvx2(const int* rowS, const int* rowV, int v, int stride,
+                         int* path)
+{
+    __m256i distV = _mm256_set1_epi32(rowS[v]);
+    __m256i prevV = _mm256_set1_epi32(v + 1);
+    __m256i none  = _mm256_set1_epi32(-1);
+    int settled = 0;
+
+    for (int w = 0; w < stride; w += 8)
+    {
+        __m256i prev, dist, cost, hit;
+
+        prev = _mm256_loadu_si256((const __m256i*)(path + w));
+        dist = _mm256_loadu_si256((const __m256i*)(rowS + w));
+        cost = _mm256_loadu_si256((const __m256i*)(rowV + w));
+        hit  = _mm256_and_si256(_mm256_cmpeq_epi32(prev, none),
+                   _mm256_cmpeq_epi32(_mm256_add_epi32(distV, cost), dist));
+        prev = _mm256_blendv_epi8(prev, prevV, hit);
+        _mm256_storeu_si256((__m256i*)(path + w), prev);
+        settled += __builtin_popcount(
+                       _mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+    } // end for (int w = 0)
+
+    return settled;
+} // end settleRowAvx2(const int*, const int*, int, int, int*)
+#endif
+
+/**---------------------- floydStride() ---------------------------------------
+ * Finds the padded row length for a matrix of a given number of nodes.
+ * @param nodes  The number of nodes in the graph.
+ * @pre nodes is not negative.
+ * @post None.
+ * @return The smallest multiple of FLOYDTILE that is at least nodes.
+ */
+int floydStride(int nodes)
+{
+    return (nodes + FLOYDTILE - 1) / FLOYDTILE * FLOYDTILE;
+} // end floydStride(int)
+
+/**---------------------- floydWarshall() -------------------------------------
+ * Turns a matrix of edge costs into a matrix of shortest distances. For each
+ * band of intermediate nodes the diagonal tile is finished first, then the
+ * tiles sharing its row or column, and then all the rest, which depend only
+ * on those and so may run in parallel.
+ * @param dist  The padded matrix; holds edge costs on entry, with 0 on the
+ *              diagonal and FLOYDINF for missing edges, including padding.
+ * @param nodes  The number of nodes in the graph.
+ * @param stride  The padded row length, from floydStride().
+ * @param pool  Workers to share the tiles among; NULL to run serially.
+ * @pre All costs are positive and no path is as long as FLOYDINF.
+ * @post dist holds the length of the shortest path between each pair of
+ *       nodes, or FLOYDINF where there is no path.
+ */
+void floydWarshall(int* dist, int nodes, int stride, WorkPool* pool)
+{
+    void (*relax)(int*, int, int, int, int) = relaxTile;
+    int tiles = (nodes + FLOYDTILE - 1) / FLOYDTILE;
+
+#ifdef FLOYD_AVX2
+    if (__builtin_cpu_supports("avx2"))
+    {
+        relax = relaxTileAvx2;
+    } // end if (__builtin_cpu_supports("avx2"))
+#endif
+
+    for (int t = 0; t < tiles; ++t)
+    {
+        int kb = t * FLOYDTILE;
+
+        relax(dist, stride, kb, kb, kb);    // diagonal tile
+
+        function<void(int)> cross = [=](int i)      // row and column tiles
+        {
+            int j = i % (tiles - 1);                // skip the diagonal
+            int other = (j < t ? j : j + 1) * FLOYDTILE;
+
+            if (i < tiles - 1)
+            {
+                relax(dist, stride, kb, other, kb);
+            }
+            else
+            {
+                relax(dist, stride, other, kb, kb);
+            } // end if (i < tiles - 1)
+        };
+
+        function<void(int)> rest = [=](int i)       // all remaining tiles
+        {
+            int ib = i / tiles * FLOYDTILE, jb = i % tiles * FLOYDTILE;
+
+            if (ib != kb && jb != kb)
+            {
+                relax(dist, stride, ib, jb, kb);
+            } // end if (ib != kb && jb != kb)
+        };
+
+        if (tiles > 1)
+        {
+            if (pool != NULL)
+            {
+                pool->run(0, 2 * (tiles - 1) - 1, cross);
+                pool->run(0, tiles * tiles - 1, rest);
+            }
+            else
+            {
+                for (int i = 0; i < 2 * (tiles - 1); ++i)
+                {
+                    cross(i);
+                } // end for (int i = 0)
+
+                for (int i = 0; i < tiles * tiles; ++i)
+                {
+                    rest(i);
+                } // end for (int i = 0)
+            } // end if (pool != NULL)
+        } // end if (tiles > 1)
+    } // end for (int t = 0)
+} // end floydWarshall(int*, int, int, WorkPool*)
+
+/**---------------------- floydPaths() ----------------------------------------
+ * Recovers the previous node on each shortest path from one source, given
+ * the finished distance matrix. Nodes are taken in the order Dijkstra's
+ * algorithm would visit them, closest first and lower numbered on ties, and
+ * each becomes the previous node of every node it reaches at exactly the
+ * shortest distance that has none yet. The result therefore matches the path
+ * matrix Dijkstra's algorithm builds.
+ * @param dist  The padded distance matrix from floydWarshall().
+ * @param cost  The padded cost matrix that dist was computed from.
+ * @param nodes  The number of nodes in the graph.
+ * @param stride  The padded row length.
+ * @param source  The row of the source node, counting from 0.
+ * @param order  Scratch space for at least nodes entries.
+ * @param path  Receives stride entries: the previous node on the path to
+ *              each node, numbered from 1, or 0 if there is none.
+ * @pre All costs are positive.
+ * @post path holds the previous node on each path from source.
+ */
+void floydPaths(const int* dist, const int* cost, int nodes, int stride,
+                int source, int* order, int* path)
+{
+    int (*settle)(const int*, const int*, int, int, int*) = settleRow;
+    const int* rowS = dist + (size_t)source * stride;
+    int reached = 0, remaining;
+
+#ifdef FLOYD_AVX2
+    if (__builtin_cpu_supports("avx2"))
+    {
+        settle = settleRowAvx2;
+    } // end if (__builtin_cpu_supports("avx2"))
+#endif
+
+    for (int w = 0; w < stride; ++w)
+    {
+        path[w] = (w < nodes && w != source && rowS[w] < FLOYDINF) ? -1 : 0;
+    } // end for (int w = 0)
+
+    for (int v = 0; v < nodes; ++v)
+    {
+        if (rowS[v] < FLOYDINF)
+        {
+            order[reached++] = v;
+        } // end if (rowS[v] < FLOYDINF)
+    } // end for (int v = 0)
+
+    sort(order, order + reached, [rowS](int a, int b)
+         { return rowS[a] < rowS[b] || (rowS[a] == rowS[b] && a < b); });
+    remaining = reached - 1;
+
+    for (int i = 0; i < reached && remaining > 0; ++i)
+    {
+        remaining -= settle(rowS, cost + (size_t)order[i] * stride, order[i],
+                            stride, path);
+    } // end for (int i = 0)
+} // end floydPaths(const int*, const int*, int, int, int, int*, int*)
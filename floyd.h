@@ -0,0 +1,30 @@
+/*
+ * @file    floyd.h
+ * @brief   These routines find the shortest paths between all pairs of nodes
+ *          with the Floyd-Warshall algorithm. The distance matrix is split
+ *          into square tiles that fit in cache, and the inner min-plus loop
+ *          runs eight lanes at a time with AVX2 when the processor supports
+ *          it, falling back to a plain loop otherwise. Matrixes are indexed
+ *          from 0 and padded so each row holds a whole number of tiles.
+ */
+
+#ifndef _FLOYD_H
+#define	_FLOYD_H
+
+#include <climits>
+#include "workpool.h"
+
+using namespace std;
+const int FLOYDTILE = 128;              // nodes along each side of a tile;
+                                        //  three tiles fit in L2 cache
+const int FLOYDINF  = INT_MAX / 2;      // distance of a missing path; the sum
+                                        //  of two never overflows an int
+
+int floydStride(int nodes);
+
+void floydWarshall(int* dist, int nodes, int stride, WorkPool* pool);
+
+void floydPaths(const int* dist, const int* cost, int nodes, int stride,
+                int source, int* order, int* path);
+
+#endif	/* _FLOYD_H */
@@ -0,0 +1,257 @@
+/*
+ * @file    graphfile.cpp
+ * @brief   This class reads graph files by mapping the whole file into memory
+ *          and scanning it with a hand-rolled integer parser. It offers the
+ *          few stream operations the graph builders use, with the same
+ *          results an ifstream would give, including when end of file and
+ *          failure are reported. Files that cannot be mapped are read into
+ *          memory instead.
+ */
+
+#include <climits>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "graphfile.h"
+
+using namespace std;
+
+
+/**---------------------- Constructor -----------------------------------------
+ * Opens a file and maps it into memory. A file that cannot be mapped, such as
+ * a pipe, is read into memory in full.
+ * @param name  The path of the file to read.
+ * @pre None.
+ * @post The file is ready to be read from its start, or operator!() reports
+ *       that it could not be opened.
+ */
+GraphFile::GraphFile(const char* name) : next(NULL), end(NULL), mapped(NULL),
+    length(0), opened(false), failed(true), ended(false)
+{
+    int         fd = open(name, O_RDONLY);
+    struct stat info;
+
+    if (fd < 0)             // file does not exist or cannot be read
+    {
+        return;
+    } // end if (fd < 0)
+
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        length = info.st_size;
+        mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapped == MAP_FAILED)
+        {
+            mapped = NULL;
+            length = 0;
+        }
+        else
+        {
+            madvise(mapped, length, MADV_SEQUENTIAL);
+            next = static_cast<const char*>(mapped);
+            end = next + length;
+        } // end if (mapped == MAP_FAILED)
+    } // end if (fstat(fd, &info) == 0 && ...)
+
+    if (mapped == NULL)     // empty, or not a regular file
+    {
+        char    buffer[65536];
+        ssize_t got;
+
+        while((got = read(fd, buffer, sizeof(buffer))) > 0)
+        {
+            copied.insert(copied.end(), buffer, buffer + got);
+        } // end while((got = read(...)) > 0)
+
+        next = (copied.empty() ? NULL : &copied[0]);
+        end = next + copied.size();
+    } // end if (mapped == NULL)
+
+    close(fd);
+    opened = true;
+    failed = false;
+} // end constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Unmaps the file.
+ * @pre None.
+ * @post All memory is freed.
+ */
+GraphFile::~GraphFile()
+{
+    if (mapped != NULL)
+    {
+        munmap(mapped, length);
+    } // end if (mapped != NULL)
+} // end destructor
+
+/**---------------------- operator!() -----------------------------------------
+ * Reports whether the last read failed or the file could not be opened.
+ * @pre None.
+ * @post None.
+ * @return true if a read failed; false, otherwise.
+ */
+bool GraphFile::operator!() const
+{
+    return failed;
+} // end operator!()
+
+/**---------------------- operator bool() -------------------------------------
+ * Reports whether reads have all succeeded so far.
+ * @pre None.
+ * @post None.
+ * @return true if no read has failed; false, otherwise.
+ */
+GraphFile::operator bool() const
+{
+    return !failed;
+} // end operator bool()
+
+/**---------------------- eof() -----------------------------------------------
+ * Reports whether a read has reached the end of the file.
+ * @pre None.
+ * @post None.
+ * @return true if the end of the file was reached; false, otherwise.
+ */
+bool GraphFile::eof() const
+{
+    return ended;
+} // end eof()
+
+/**---------------------- get() -----------------------------------------------
+ * Reads a single character.
+ * @pre None.
+ * @post The character is consumed. At the end of the file, or once a read
+ *       has failed or ended, the file is marked as failed.
+ * @return The character read, or EOF.
+ */
+int GraphFile::get()
+{
+    if (failed || ended || next == end)     // as a stream, fail once ended
+    {
+        failed = true;
+        ended = (next == end);
+        return EOF;
+    } // end if (failed || ended || next == end)
+
+    return static_cast<unsigned char>(*next++);
+} // end get()
+
+/**---------------------- operator>>() ----------------------------------------
+ * Reads a decimal integer after skipping white space. As with a stream, a
+ * missing number fails and stores 0, a number out of range fails and stores
+ * the nearest limit, and a number that runs to the end of the file marks
+ * the file as ended without failing.
+ * @param value  Receives the number read.
+ * @pre None.
+ * @post The number and any white space before it are consumed.
+ * @return This file, for chaining.
+ */
+GraphFile& GraphFile::operator>>(int& value)
+{
+    const char* scan = next;        // kept local so it stays in a register
+    const char* stop = end;
+    const char* digits;
+    long long   number = 0;
+    bool        negative = false;
+    bool        overflow = false;   // a digit was dropped
+    unsigned    digit;
+
+    if (failed || ended)        // as a stream, fail once ended
+    {
+        failed = true;
+        return *this;
+    } // end if (failed || ended)
+
+    while(scan != stop && (*scan == ' ' || (*scan >= '\t' && *scan <= '\r')))
+    {
+        ++scan;
+    } // end while(scan != stop && ...)
+
+    if (scan != stop && (*scan == '-' || *scan == '+'))
+    {
+        negative = (*scan++ == '-');
+    } // end if (scan != stop && ...)
+
+    for (digits = scan; scan != stop; ++scan)
+    {
+        digit = (unsigned)(*scan - '0');
+
+        if (digit > 9)
+        {
+            break;
+        } // end if (digit > 9)
+
+        if (number <= INT_MAX)      // stop growing once out of range
+        {
+            number = number * 10 + digit;
+        }
+        else
+        {
+            overflow = true;
+        } // end if (number <= INT_MAX)
+    } // end for (digits = scan)
+
+    next = scan;
+    ended = (scan == stop);
+
+    if (scan == digits)             // no number here
+    {
+        failed = true;
+        value = 0;
+    }
+    else if (overflow || number > (negative ? -(long long)INT_MIN : INT_MAX))
+    {
+        failed = true;
+        value = (negative ? INT_MIN : INT_MAX);
+    }
+    else
+    {
+        value = (int)(negative ? -number : number);
+    } // end if (scan == digits)
+
+    return *this;
+} // end operator>>(int&)
+
+/**---------------------- getline() -------------------------------------------
+ * Reads the rest of the current line, not including the end of line.
+ * @param input  The file from which to read.
+ * @param line  Receives the text read.
+ * @pre None.
+ * @post The line and its end of line are consumed. A line that runs to the
+ *       end of the file marks the file as ended; reading at the end of the
+ *       file also fails.
+ * @return input, for chaining.
+ */
+GraphFile& getline(GraphFile& input, string& line)
+{
+    const char* start = input.next;
+
+    if (input.failed || input.ended)    // as a stream, fail once ended
+    {
+        input.failed = true;
+        return input;
+    } // end if (input.failed || input.ended)
+
+    while(input.next != input.end && *input.next != '\n')
+    {
+        ++input.next;
+    } // end while(input.next != input.end && ...)
+
+    line.assign(start, input.next - start);
+
+    if (input.next == input.end)
+    {
+        input.ended = true;
+        input.failed = (start == input.end);
+    }
+    else
+    {
+        ++input.next;               // consume end of line
+    } // end if (input.next == input.end)
+
+    return input;
+} // end getline(GraphFile&, string&)
@@ -0,0 +1,56 @@
+/*
+ * @file    graphfile.h
+ * @brief   This class reads graph files by mapping the whole file into memory
+ *          and scanning it with a hand-rolled integer parser. It offers the
+ *          few stream operations the graph builders use, with the same
+ *          results an ifstream would give, including when end of file and
+ *          failure are reported. Files that cannot be mapped are read into
+ *          memory instead.
+ */
+
+#ifndef _GRAPHFILE_H
+#define	_GRAPHFILE_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+class GraphFile
+{
+public:
+
+    GraphFile(const char* name);
+
+    virtual ~GraphFile();
+
+    bool operator!(void) const;
+
+    explicit operator bool(void) const;
+
+    bool eof(void) const;
+
+    int get(void);
+
+    GraphFile& operator>>(int& value);
+
+    friend GraphFile& getline(GraphFile& input, string& line);
+
+private:
+
+    const char*  next;          // next character to read
+    const char*  end;           // one past the last character
+    void*        mapped;        // start of the mapping, if any
+    size_t       length;        // bytes mapped
+    vector<char> copied;        // file contents, if they could not be mapped
+    bool         opened;        // the file could be read
+    bool         failed;        // a read failed, as failbit would be set
+    bool         ended;         // end of file was reached, as eofbit
+
+    GraphFile(const GraphFile&);            // the mapping cannot be shared
+    GraphFile& operator=(const GraphFile&);
+
+}; // end class GraphFile
+
+#endif	/* _GRAPHFILE_H */
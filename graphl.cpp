@@ -3,79 +3,129 @@
  * @brief   This class represents a graph using an adjacency list. Each node in
  *          the graph is represented by an index in the list. The elements of
  *          the list include a list of nodes to which the indicated node is
- *          adjacent. The graph does not keep track of its size.
+ *          adjacent. Once built, the lists are packed into one array of edges
+ *          with the offset of each node's edges, and the lists are freed. The
+ *          graph does not keep track of its size.
  * @author  Brendan Sweeney, SID 1161836
  * @date    February 2, 2012
  */
 
+#include <new>
 #include "graphl.h"
 
 
 /**---------------------- Default Constructor ---------------------------------
- * Creates an empty graph and sets all pointers to NULL.
+ * Creates an empty graph. The adjacency list is sized when the graph is built.
  * @pre None.
- * @post An empty graph exists. All pointers are NULL.
+ * @post An empty graph exists.
  */
 GraphL::GraphL()
 {
-    for (int i = 0; i < GRAPHNODELIMIT; ++i)
-    {
-        adjList[i] = NULL;
-    } // end for (int i = 0)
 } // end constructor
 
 /**---------------------- Destructor ------------------------------------------
- * Deletes all dynamically allocated memory and sets remaining pointers to
- * NULL.
+ * Deletes all dynamically allocated memory.
  * @pre None.
- * @post All memory is freed and any pointers are NULL.
+ * @post All memory is freed.
  */
 GraphL::~GraphL()
 {
-    EdgeNode* delPtr;
+    clear();
+} // end destructor
+
+/**---------------------- clear() ---------------------------------------------
+ * Frees the adjacency lists. Nodes and edges all live in the arena, so the
+ * nodes are destroyed in place and every block is then freed at once.
+ * @pre None.
+ * @post The adjacency lists are empty and their memory is freed.
+ */
+void GraphL::clear()
+{
+    for (int i = 1; i < (int)adjList.size(); ++i)
+    {
+        adjList[i]->~GraphNode();
+    } // end for (int i = 1)
+
+    adjList.clear();
+    arena.release();
+} // end clear()
+
+/**---------------------- compress() ------------------------------------------
+ * Packs the adjacency lists into the edge arrays and frees the lists. Each
+ * node's edges keep their list order, newest first.
+ * @param edges  The number of edges in the lists.
+ * @pre The adjacency lists hold the whole graph.
+ * @post edgeStart[v] through edgeStart[v + 1] - 1 index the edges of node v
+ *       in edgeDest, and the adjacency lists are freed.
+ */
+void GraphL::compress(int edges)
+{
+    int nodes = (int)adjList.size();            // one more than the count
 
-    for (int i = 1; i < GRAPHNODELIMIT && adjList[i] != NULL; ++i)
+    edgeStart.assign(nodes + 1, 0);
+    edgeDest.clear();
+    edgeDest.reserve(edges);
+
+    for (int i = 1; i < nodes; ++i)
     {
-        delPtr = adjList[i]->edgeHead;
+        edgeStart[i] = (int)edgeDest.size();
 
-        while(delPtr != NULL)
+        for (EdgeNode* cur = adjList[i]->edgeHead; cur != NULL;
+             cur = cur->nextEdge)
         {
-            adjList[i]->edgeHead = adjList[i]->edgeHead->nextEdge;
-            delete delPtr;
-            delPtr = adjList[i]->edgeHead;
-        } // end while(delPtr != NULL)
+            edgeDest.push_back(cur->adjGraphNode);
+        } // end for (EdgeNode* cur = adjList[i]->edgeHead)
     } // end for (int i = 1)
 
-    delPtr = NULL;
-} // end destructor
+    edgeStart[nodes] = (int)edgeDest.size();
+    clear();
+} // end compress(int)
 
-/**---------------------- buildGraph() ----------------------------------------
- * Constructs a graph from an input file.
+/**---------------------- readGraph() -----------------------------------------
+ * Constructs a graph from an input file; buildGraph() shares this for each
+ * kind of input. The adjacency list is sized from the number of nodes on the
+ * first line. Edges are gathered in adjacency lists and then packed by
+ * compress(). Any graph built before is discarded.
  * @param input  The file from which to read the data for all ndoes.
- * @pre The ifstream input can be read.
+ * @pre The input can be read.
  * @post This graph represents the graph described in input.
  */
-void GraphL::buildGraph(ifstream& input)
+template <class Input>
+void GraphL::readGraph(Input& input)
 {
-    int    nodeCount, source, dest;         // containers for validation
+    int    nodeCount = 0, source = 0, dest;     // containers for validation
+    int    edges = 0;
     string description;
+    STATS_TIME(counters.buildNs);
 
+    clear();
+    names.clear();
+    edgeStart.clear();
+    edgeDest.clear();
+    innerOf.clear();
+    outerOf.clear();
     input >> nodeCount;         // expect positive int for size
 
-    if (nodeCount > 0 && nodeCount < GRAPHNODELIMIT)    // valid number nodes
+    if (nodeCount > 0)          // valid number of nodes
     {
+        GraphNode* nodes = static_cast<GraphNode*>(     // one slab for all
+                arena.allocate(nodeCount * sizeof(GraphNode)));
+
         input.get();            // clear end of line
+        adjList.assign(nodeCount + 1, NULL);
+        names.reserve(nodeCount);
 
         for (int i = 1; i <= nodeCount; ++i)
         {
             getline(input, description);    // each line, one per node, should
-            adjList[i] = new GraphNode();   //  contain description of node
-            adjList[i]->data = description;
+                                            //  contain description of node
+            adjList[i] = new (&nodes[i - 1]) GraphNode();
+            names.add(description);
         } // end for (int i = 1)
 
         input >> source >> dest;            // get first edge
 
-        while(source != 0)  // check for termination of input
+        while(source != 0 && input)     // check for termination of input
         {
             input.get();    // clear end of line
 
@@ -83,13 +133,42 @@ void GraphL::buildGraph(ifstream& input)
             {
                 cerr << "ERROR: Could not insert edge (" << source << ", " <<
                         dest << ")" << endl;
+            }
+            else
+            {
+                ++edges;
             } // end if (!insertEdge(source, dest, cost))
 
             input >> source >> dest;            // get next edge
         } // end while(source != 0)
+
+        compress(edges);
     } // end if (nodeCount >= 0)
+} // end readGraph(Input&)
+
+/**---------------------- buildGraph() ----------------------------------------
+ * Builds a graph from data in an ifstream, formatted as for readGraph().
+ * @param input  The stream from which to read a graph structure.
+ * @pre The ifstream is readable and contains a valid graph description.
+ * @post This graph will represent the data from input.
+ */
+void GraphL::buildGraph(ifstream& input)
+{
+    readGraph(input);
 } // end buildGraph(ifstream&)
 
+/**---------------------- buildGraph() ----------------------------------------
+ * Builds a graph from data in a mapped graph file, formatted as for
+ * readGraph(). This is much faster than reading from an ifstream.
+ * @param input  The file from which to read a graph structure.
+ * @pre The file is readable and contains a valid graph description.
+ * @post This graph will represent the data from input.
+ */
+void GraphL::buildGraph(GraphFile& input)
+{
+    readGraph(input);
+} // end buildGraph(GraphFile&)
+
 /**---------------------- insertEdge() ----------------------------------------
  * Inserts a single edge into this graph.
  * @param source  The starting node.
@@ -106,7 +185,8 @@ bool GraphL::insertEdge(int source, int dest, int size)
 
     if (success)    // input is within list bounds
     {
-        EdgeNode* newPtr = new EdgeNode;        // for pointer redirection
+        EdgeNode* newPtr = static_cast<EdgeNode*>(      // for pointer
+                arena.allocate(sizeof(EdgeNode)));      //  redirection
         newPtr->adjGraphNode = dest;            // initialize new node
         newPtr->nextEdge = adjList[source]->edgeHead;
         adjList[source]->edgeHead = newPtr;     // insert at list head
@@ -116,54 +196,181 @@ bool GraphL::insertEdge(int source, int dest, int size)
     return success;
 } // end insertEdge(int, int, int)
 
+/**---------------------- reorder() -------------------------------------------
+ * Renumbers the nodes of this graph inside it so that nodes joined by edges
+ * have their edges near each other, which keeps a search within fewer cache
+ * lines on a large graph. Each node's edges keep their order, and every
+ * method still takes and gives the input numbers, so the search order and
+ * every report are exactly as before. INPUT_ORDER undoes any renumbering,
+ * and does nothing to a graph that has none.
+ * @param order  The numbering to use; see orderNodes().
+ * @pre None.
+ * @post The nodes are numbered by order inside this graph.
+ */
+void GraphL::reorder(NodeOrder order)
+{
+    int         nodes = names.size();
+    vector<int> perm;                   // present number of each new number
+    vector<int> renumber(nodes + 1, 0); // new number of each present number
+    vector<int> input(nodes + 1, 0);    // input number of each new number
+    vector<int> start(nodes + 2, 0);    // the edge arrays, renumbered
+    vector<int> dest;
+
+    if (nodes == 0 || (order == INPUT_ORDER && innerOf.empty()))
+    {
+        return;
+    } // end if (nodes == 0 || ...)
+
+    if (order == INPUT_ORDER && !innerOf.empty())
+    {
+        perm = innerOf;
+    }
+    else
+    {
+        perm = orderNodes(order, nodes, edgeStart, edgeDest);
+    } // end if (order == INPUT_ORDER && !innerOf.empty())
+
+    for (int k = 1; k <= nodes; ++k)
+    {
+        renumber[perm[k]] = k;
+        input[k] = outer(perm[k]);
+    } // end for (int k = 1)
+
+    dest.reserve(edgeDest.size());
+
+    for (int k = 1; k <= nodes; ++k)
+    {
+        start[k] = (int)dest.size();
+
+        for (int e = edgeStart[perm[k]]; e < edgeStart[perm[k] + 1]; ++e)
+        {
+            dest.push_back(renumber[edgeDest[e]]);
+        } // end for (int e = edgeStart[perm[k]])
+    } // end for (int k = 1)
+
+    start[nodes + 1] = (int)dest.size();
+    edgeStart.swap(start);
+    edgeDest.swap(dest);
+    innerOf.clear();
+    outerOf.clear();
+
+    if (order != INPUT_ORDER)
+    {
+        outerOf.swap(input);
+        innerOf.assign(nodes + 1, 0);
+
+        for (int k = 1; k <= nodes; ++k)
+        {
+            innerOf[outerOf[k]] = k;
+        } // end for (int k = 1)
+    } // end if (order != INPUT_ORDER)
+} // end reorder(NodeOrder)
+
 /**---------------------- depthFirstSearch() ----------------------------------
  * Lists the nodes in depth-first-search order.
  * @pre None.
  * @post None.
  */
 void GraphL::depthFirstSearch()
-{   // initialize graph for search
-    for (int i = 1; i < GRAPHNODELIMIT && adjList[i] != NULL; ++i)
-    {
-        adjList[i]->visited = false;
-    } // end for (int i = 1)
+{
+    vector<int> order = depthFirstOrder();
 
     cout << endl << "Depth-first ordering: ";
 
-    for (int v = 1; v < GRAPHNODELIMIT && adjList[v] != NULL; ++v)
+    for (int i = 0; i < (int)order.size(); ++i)
     {
-        if (!adjList[v]->visited)
-        {
-            dfs(v);
-        } // end if (!adjList[v]->visited)
-    } // end for (int v = 1)
-    
+        cout << order[i] << ' ';
+    } // end for (int i = 0)
+
     cout << endl << endl;
 } // end depthFirstSearch()
 
+/**---------------------- depthFirstOrder() -----------------------------------
+ * Finds the nodes in depth-first-search order. Searches start from each
+ * unvisited node in turn, lowest numbered first, and follow edges in list
+ * order. Nodes are numbered as in the input, however this graph is ordered.
+ * @pre None.
+ * @post None.
+ * @return Every node, in the order it is first visited.
+ */
+vector<int> GraphL::depthFirstOrder() const
+{
+    vector<uint64_t> visited(names.size() / 64 + 1, 0);    // one bit per node
+    vector<int>      order;
+    STATS_TIME(counters.dfsNs);
+
+    order.reserve(names.size());
+
+    for (int i = 1; i <= names.size(); ++i)
+    {
+        int v = inner(i);
+
+        if (!(visited[v / 64] >> (v % 64) & 1))
+        {
+            dfs(v, visited, order);
+        } // end if (!(visited[v / 64] >> (v % 64) & 1))
+    } // end for (int i = 1)
+
+    for (int i = 0; !outerOf.empty() && i < (int)order.size(); ++i)
+    {
+        order[i] = outerOf[order[i]];
+    } // end for (int i = 0)
+
+    return order;
+} // end depthFirstOrder()
+
 /**---------------------- dfs() -----------------------------------------------
- * Helper for depthFirstSearch().
+ * Helper for depthFirstOrder(). The search keeps its own stack of nodes and
+ * the next edge to follow from each, so a long path cannot overflow the call
+ * stack. Nodes are visited in the same order a recursive search would use.
  * @param v  The node to start searching from.
+ * @param visited  One bit per node, set for nodes already visited.
+ * @param order  The nodes visited so far.
  * @pre v is the proper node to search from.
- * @post All nodes from v have been visited.
+ * @post All nodes from v have been visited and appended to order.
  */
-void GraphL::dfs(int v)
+void GraphL::dfs(int v, vector<uint64_t>& visited, vector<int>& order) const
 {
-    EdgeNode* visit = adjList[v]->edgeHead;
-    
-    adjList[v]->visited = true;
-    cout << v << ' ';
-    
-    while(visit != NULL)
+    vector<int> stack;      // next edge to follow, per open node
+    vector<int> ends;       // end of the edges, per open node
+    int         visit, w;
+    STATS_LOCAL(followed);
+
+    visited[v / 64] |= (uint64_t)1 << (v % 64);
+    order.push_back(v);
+    stack.push_back(edgeStart[v]);
+    ends.push_back(edgeStart[v + 1]);
+
+    while(!stack.empty())
     {
-        if (!adjList[visit->adjGraphNode]->visited)
+        visit = stack.back();
+
+        while(visit < ends.back() && (visited[edgeDest[visit] / 64] >>
+                                      (edgeDest[visit] % 64) & 1))
+        {
+            ++visit;                        // skip visited neighbors
+            STATS_ADD(followed, 1);
+        } // end while(visit < ends.back() && ...)
+
+        if (visit == ends.back())           // every edge has been followed
+        {
+            stack.pop_back();
+            ends.pop_back();
+        }
+        else                                // descend into next neighbor
         {
-            dfs(visit->adjGraphNode);
-        } // end if (!adjList[visit->adjGraphNode]->visited)
+            w = edgeDest[visit];
+            stack.back() = visit + 1;
+            STATS_ADD(followed, 1);
+            visited[w / 64] |= (uint64_t)1 << (w % 64);
+            order.push_back(w);
+            stack.push_back(edgeStart[w]);
+            ends.push_back(edgeStart[w + 1]);
+        } // end if (visit == ends.back())
+    } // end while(!stack.empty())
 
-        visit = visit->nextEdge;
-    } // end while(visit != NULL)
-} // end dfs(int)
+    STATS_ADD(counters.dfsEdges, followed);
+} // end dfs(int, vector<uint64_t>&, vector<int>&)
 
 /**---------------------- displayGraph() --------------------------------------
  * Prints out the nodes and their edges.
@@ -172,23 +379,79 @@ void GraphL::dfs(int v)
  */
 void GraphL::displayGraph() const
 {
-    EdgeNode* cur;      // for edge list traversal
-
     cout << endl << "Graph:" << endl;
 
-    for (int i = 1; i < GRAPHNODELIMIT && adjList[i] != NULL; ++i)
+    for (int i = 1; i <= names.size(); ++i)
     {
-        cout << "Node " << setw(4) << i << "        "
-             << adjList[i]->data << endl;
-        
-        cur = adjList[i]->edgeHead;
+        int v = inner(i);
 
-        while(cur != NULL)
+        cout << "Node " << setw(4) << i << "        ";
+        cout.write(names.text(i), names.length(i)) << endl;
+
+        for (int e = edgeStart[v]; e < edgeStart[v + 1]; ++e)
         {
-            cout << "  edge " << i << ' ' << cur->adjGraphNode << endl;
-            cur = cur->nextEdge;
-        } // end while(cur != NULL)
+            cout << "  edge " << i << ' ' << outer(edgeDest[e]) << endl;
+        } // end for (int e = edgeStart[v])
     } // end for (int i = 1)
 
     cout << endl;
 } // end displayGraph()
+
+/**---------------------- inner() ---------------------------------------------
+ * Turns an input node number into the number this graph uses inside.
+ * @param id  The input number.
+ * @pre None.
+ * @post None.
+ * @return The inside number; id itself if the graph is not renumbered.
+ */
+int GraphL::inner(int id) const
+{
+    return innerOf.empty() ? id : innerOf[id];
+} // end inner(int)
+
+/**---------------------- outer() ---------------------------------------------
+ * Turns a node number used inside this graph into its input number.
+ * @param v  The inside number.
+ * @pre None.
+ * @post None.
+ * @return The input number; v itself if the graph is not renumbered.
+ */
+int GraphL::outer(int v) const
+{
+    return outerOf.empty() ? v : outerOf[v];
+} // end outer(int)
+
+/**---------------------- findNode() ------------------------------------------
+ * Finds a node by its description through a hash index.
+ * @param description  The description to look for.
+ * @pre None.
+ * @post None.
+ * @return The lowest numbered node with that description; 0 if none has it.
+ */
+int GraphL::findNode(const string& description) const
+{
+    return names.find(description);
+} // end findNode(const string&)
+
+/**---------------------- stats() ---------------------------------------------
+ * Reports what building and searching have done since the graph was created
+ * or resetStats() was last called. The counters only move when the program
+ * is built with GRAPH_STATS; they read zero otherwise.
+ * @pre None.
+ * @post None.
+ * @return The counters and phase timers of this graph.
+ */
+const PathStats& GraphL::stats() const
+{
+    return counters;
+} // end stats()
+
+/**---------------------- resetStats() ----------------------------------------
+ * Sets the counters and phase timers of this graph back to zero.
+ * @pre None.
+ * @post Every counter and timer is zero.
+ */
+void GraphL::resetStats()
+{
+    counters.reset();
+} // end resetStats()
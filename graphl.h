@@ -3,7 +3,9 @@
  * @brief   This class represents a graph using an adjacency list. Each node in
  *          the graph is represented by an index in the list. The elements of
  *          the list include a list of nodes to which the indicated node is
- *          adjacent. The graph does not keep track of its size.
+ *          adjacent. Once built, the lists are packed into one array of edges
+ *          with the offset of each node's edges, and the lists are freed. The
+ *          graph does not keep track of its size.
  * @author  Brendan Sweeney, SID 1161836
  * @date    February 2, 2012
  */
@@ -12,19 +14,24 @@
 #define	_GRAPHL_H
 
 #include <cstdlib>
+#include <fstream>
 #include <iomanip>
-#include "nodedata.h"
+#include <iostream>
+#include <stdint.h>
+#include <vector>
+#include "arena.h"
+#include "graphfile.h"
+#include "nametable.h"
+#include "nodeorder.h"
+#include "pathstats.h"
 
 using namespace std;
-const int GRAPHNODELIMIT = 101;
 
 
 struct EdgeNode;                // forward reference for the compiler
-struct GraphNode
+struct GraphNode                // used only while the graph is built
 {
     EdgeNode* edgeHead;         // head of the list of edges
-    NodeData  data;             // information about the node
-    bool      visited;          // used during recursive searches
 }; // end GraphNode
 
 struct EdgeNode
@@ -43,17 +50,49 @@ public:
     
     void buildGraph(ifstream& input);
 
+    void buildGraph(GraphFile& input);
+
+    void reorder(NodeOrder order);
+
     void depthFirstSearch(void);
 
+    vector<int> depthFirstOrder(void) const;
+
     void displayGraph(void) const;
 
+    int findNode(const string& description) const;
+
+    const PathStats& stats(void) const;
+
+    void resetStats(void);
+
 private:
 
-    GraphNode* adjList[GRAPHNODELIMIT];     // adjacency list of nodes
+    vector<GraphNode*> adjList;             // adjacency list while building
+    Arena              arena;               // holds all nodes and edges
+    NameTable          names;               // interned node descriptions,
+                                            //  by input number
+    vector<int>        edgeStart;           // first edge of each node
+    vector<int>        edgeDest;            // adjacent node of each edge
+    vector<int>        innerOf;             // node number of each input
+    vector<int>        outerOf;             //  number, and back; both empty
+                                            //  while the numbers match
+    mutable PathStats  counters;            // hot path statistics
+
+    template <class Input>
+    void readGraph(Input& input);
+
+    void clear(void);
+
+    void compress(int edges);
 
     bool insertEdge(int source, int dest, int size);
 
-    void dfs(int v);
+    int inner(int id) const;
+
+    int outer(int v) const;
+
+    void dfs(int v, vector<uint64_t>& visited, vector<int>& order) const;
 
 }; // end GraphL
 
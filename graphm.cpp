@@ -9,222 +9,2299 @@
  * @date    February 2, 2012
  */
 
+#include <algorithm>
 #include <climits>
+#include <cstring>
+#include <sstream>
 #include <string>
+#include "floyd.h"
 #include "graphm.h"
+#include "snapshot.h"
+#include "workpool.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GRAPHM_AVX2     // AVX2 row scans are compiled and chosen at run time
+#endif
 
 using namespace std;
 
+#ifdef GRAPHM_AVX2
+/**---------------------- cpuHasAvx2() ----------------------------------------
+ * Reports whether the processor supports AVX2, asking it only once.
+ * @pre None.
+ * @post None.
+ * @return true if AVX2 instructions may be used; false, otherwise.
+ */
+static bool cpuHasAvx2(void)
+{
+    static const bool hasAvx2 = (__builtin_cpu_init(),
+                                 __builtin_cpu_supports("avx2"));
+
+    return hasAvx2;
+} // end cpuHasAvx2()
+
+/**---------------------- findVAvx2() -----------------------------------------
+ * Finds the unvisited node with the least distance in a padded row, eight
+ * nodes at a time. The first pass finds the least distance; the second finds
+ * the lowest numbered node holding it.
+ * @param dist  The distances in the row, aligned to a cache line.
+ * @param visited  One bit per node, set for nodes already visited.
+ * @param stride  The padded row length, a multiple of eight.
+ * @pre The processor supports AVX2. Padding holds INT_MAX.
+ * @post None.
+ * @return The node to visit next, or 0 if none is reachable.
+ */
+__attribute__((target("avx2")))
+static int findVAvx2(const int* dist, const uint64_t* visited, int stride)
+{
+    const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i none = _mm256_set1_epi32(INT_MAX);
+    __m256i least = none, lanes, seen;
+    __m128i half;
+    int     best;
+
+    for (int i = 0; i < stride; i += 8)
+    {
+        seen  = _mm256_set1_epi32((int)(visited[i / 64] >> (i % 64)) & 0xFF);
+        seen  = _mm256_cmpeq_epi32(_mm256_and_si256(seen, bits), bits);
+        lanes = _mm256_load_si256((const __m256i*)(dist + i));
+        least = _mm256_min_epi32(least, _mm256_blendv_epi8(lanes, none, seen));
+    } // end for (int i = 0)
+
+    half = _mm_min_epi32(_mm256_castsi256_si128(least),
+                         _mm256_extracti128_si256(least, 1));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    best = _mm_cvtsi128_si32(half);
+
+    if (best == INT_MAX)    // every unvisited node is unreachable
+    {
+        return 0;
+    } // end if (best == INT_MAX)
+
+    least = _mm256_set1_epi32(best);
+
+    for (int i = 0; i < stride; i += 8)
+    {
+        int match;
+
+        seen  = _mm256_set1_epi32((int)(visited[i / 64] >> (i % 64)) & 0xFF);
+        seen  = _mm256_cmpeq_epi32(_mm256_and_si256(seen, bits), bits);
+        lanes = _mm256_load_si256((const __m256i*)(dist + i));
+        lanes = _mm256_blendv_epi8(lanes, none, seen);
+        match = _mm256_movemask_ps(
+                    _mm256_castsi256_ps(_mm256_cmpeq_epi32(lanes, least)));
+
+        if (match != 0)
+        {
+            return i + __builtin_ctz(match);
+        } // end if (match != 0)
+    } // end for (int i = 0)
+
+    return 0;
+} // end findVAvx2(const int*, const uint64_t*, int)
+
+/**---------------------- setWAvx2() ------------------------------------------
+ * Relaxes every edge leaving a visited node, eight nodes at a time. With
+ * GRAPH_STATS the shortened paths are counted as well.
+ * @param dist  The distances in the row, aligned to a cache line.
+ * @param path  The previous nodes in the row, aligned the same way.
+ * @param costs  The row of the cost matrix for v, aligned the same way.
+ * @param v  The node being visited.
+ * @param stride  The padded row length, a multiple of eight.
+ * @pre The processor supports AVX2. dist[v] is less than INT_MAX.
+ * @post Each node adjacent to v holds the shorter of its old path and the
+ *       path through v.
+ * @return The number of paths shortened, or 0 without GRAPH_STATS.
+ */
+__attribute__((target("avx2")))
+static int setWAvx2(int* dist, int* path, const int* costs, int v,
+                    int stride)
+{
+    const __m256i none  = _mm256_set1_epi32(INT_MAX);
+    const __m256i distV = _mm256_set1_epi32(dist[v]);
+    const __m256i prevV = _mm256_set1_epi32(v);
+    int shortened = 0;
+
+    for (int w = 0; w < stride; w += 8)
+    {
+        __m256i cost, old, via, better;
+
+        cost   = _mm256_load_si256((const __m256i*)(costs + w));
+        old    = _mm256_load_si256((const __m256i*)(dist + w));
+        via    = _mm256_add_epi32(distV, cost);
+        better = _mm256_andnot_si256(_mm256_cmpeq_epi32(cost, none),
+                                     _mm256_cmpgt_epi32(old, via));
+        _mm256_store_si256((__m256i*)(dist + w),
+                           _mm256_blendv_epi8(old, via, better));
+        old    = _mm256_load_si256((const __m256i*)(path + w));
+        _mm256_store_si256((__m256i*)(path + w),
+                           _mm256_blendv_epi8(old, prevV, better));
+#ifdef GRAPH_STATS
+        shortened += __builtin_popcount(
+                         _mm256_movemask_ps(_mm256_castsi256_ps(better)));
+#endif
+    } // end for (int w = 0)
+
+    return shortened;
+} // end setWAvx2(int*, int*, const int*, int, int)
+#endif
+
+/**---------------------- pathRowValid() --------------------------------------
+ * Checks a stored row of the path matrix before it is trusted. The source is
+ * at distance 0 with no previous node; every other node reached has a
+ * previous node in the graph that is strictly closer, so following previous
+ * nodes always ends at the source; every node not reached has none.
+ * @param row  The row: nodes distances, then nodes previous nodes, for
+ *             nodes 1 to nodes.
+ * @param nodes  The number of nodes.
+ * @param source  The node the row is from.
+ * @pre None.
+ * @post None.
+ * @return true if the row is well formed; false, otherwise.
+ */
+static bool pathRowValid(const int* row, int nodes, int source)
+{
+    const int* dist = row - 1;          // indexed by node
+    const int* path = row + nodes - 1;
+
+    if (dist[source] != 0 || path[source] != 0)
+    {
+        return false;
+    } // end if (dist[source] != 0 || ...)
+
+    for (int w = 1; w <= nodes; ++w)
+    {
+        int v = path[w];
+
+        if (w == source)
+        {
+            continue;
+        } // end if (w == source)
+
+        if (dist[w] == INT_MAX ? v != 0 :
+            (dist[w] < 0 || v < 1 || v > nodes || dist[v] >= dist[w]))
+        {
+            return false;
+        } // end if (dist[w] == INT_MAX ? ...)
+    } // end for (int w = 1)
+
+    return true;
+} // end pathRowValid(const int*, int, int)
+
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an empty graph. No storage is allocated until the number of nodes
+ * is known.
+ * @pre None.
+ * @post An empty graph exists.
+ */
+GraphM::GraphM() : size(0), stride(0), engine(AUTO_ENGINE), edges(0),
+                   edged(false), maxCost(0), threads(1), repair(true),
+                   queryId(0), ranked(false)
+{
+} // end Constructor
+
+/**---------------------- readGraph() -----------------------------------------
+ * Builds a graph from data in a stream or graph file; buildGraph() shares
+ * this for each kind of input. The input file must be formatted so
+ * that the first line contains only the number of nodes. The next lines should
+ * contain text descriptions of the nodes, one per line, for as many lines as
+ * were specified by the integer on the first line. All remaining lines should
+ * contain three integers separated by white space. These represent edges. The
+ * first is the starting node, the second the destination node, and the third
+ * is the cost of the edge. Input it terminated when an edge line begins with a
+ * 0. The matrixes are sized from the number of nodes, so there is no limit on
+ * the size of a graph other than available memory. Each row is padded to a
+ * whole number of cache lines.
+ * @param input  The stream from which to read a graph structure. Must be
+ *               formatted as described above.
+ * @pre The input is readable and contains a valid graph description.
+ * @post This graph will represent the data from input.
+ */
+template <class Input>
+void GraphM::readGraph(Input& input)
+{
+    int    nodeCount = 0, source = 0, dest, cost; // containers for validation
+    string description;
+    STATS_TIME(counters.buildNs);
+
+    input >> nodeCount;         // expect positive int for size
+
+    if (nodeCount > 0)          // valid number of nodes
+    {
+        input.get();            // clear end of line
+        sizeGraph(nodeCount);   // number of nodes to expect from file
+
+        for (int i = 1; i <= size; ++i)
+        {
+            getline(input, description);    // each line, one per node, should
+            names.add(description);         //  contain description of node
+        } // end for (int i = 1)
+
+        input >> source >> dest >> cost;    // get first edge
+
+        while(source != 0 && input)     // check for termination of input
+        {
+            input.get();    // clear end of line
+            
+            if (!loadEdge(source, dest, cost))      // insert failed
+            {
+                cerr << "ERROR: Could not insert edge (" << source << ", " <<
+                        dest << ") with cost of " << cost << endl;
+            } // end if (!loadEdge(source, dest, cost))
+
+            input >> source >> dest >> cost;        // get next edge
+        } // end while(source != 0)
+    } // end if (nodeCount >= 0)
+} // end readGraph(Input&)
+
+/**---------------------- buildGraph() ----------------------------------------
+ * Builds a graph from data in an ifstream, formatted as for readGraph().
+ * @param input  The stream from which to read a graph structure.
+ * @pre The ifstream is readable and contains a valid graph description.
+ * @post This graph will represent the data from input.
+ */
+void GraphM::buildGraph(ifstream& input)
+{
+    readGraph(input);
+} // end buildGraph(ifstream&)
+
+/**---------------------- buildGraph() ----------------------------------------
+ * Builds a graph from data in a mapped graph file, formatted as for
+ * readGraph(). This is much faster than reading from an ifstream.
+ * @param input  The file from which to read a graph structure.
+ * @pre The file is readable and contains a valid graph description.
+ * @post This graph will represent the data from input.
+ */
+void GraphM::buildGraph(GraphFile& input)
+{
+    readGraph(input);
+} // end buildGraph(GraphFile&)
+
+/**---------------------- saveSnapshot() --------------------------------------
+ * Writes this graph to a binary snapshot that loadSnapshot() can read back
+ * far faster than the text format can be parsed. The snapshot holds the node
+ * descriptions and the edges, one row of (node, cost) pairs per node, and
+ * optionally the path matrix along with which of its rows are current. A
+ * renumbered graph is written with its input numbers, and loads that way.
+ * @param name  The path of the file to write.
+ * @param withPaths  true to include the path matrix.
+ * @pre None.
+ * @post The file holds a snapshot of this graph.
+ * @return true if the snapshot was written in full; false, otherwise.
+ */
+bool GraphM::saveSnapshot(const char* name, bool withPaths) const
+{
+    SnapshotWriter   output(name);
+    SnapshotHeader   header;
+    vector<uint32_t> lengths;           // length of each description
+    vector<int>      starts(1, 0);      // first edge of each node
+    vector<int>      pairs;             // (node, cost) of each edge
+    vector<char>     rows(size + 1);    // which rows of the path matrix
+    vector<int>      paths;             //  are current, and one row
+    ostringstream    text;              // all descriptions, end to end
+    bool             good;
+
+    withPaths = withPaths && size > 0;  // an empty graph has no paths
+
+    for (int i = 1; i <= size; ++i)
+    {
+        size_t before = text.tellp();
+        int    row = inner(i);
+
+        text.write(names.text(i), names.length(i));
+        lengths.push_back((uint32_t)((size_t)text.tellp() - before));
+        starts.push_back(starts.back());
+        rows[i] = pathed[row];
+
+        for (int j = 1; j <= size; ++j)
+        {
+            if (j != i && C[cell(row, inner(j))] != INT_MAX)
+            {
+                pairs.push_back(j);
+                pairs.push_back(C[cell(row, inner(j))]);
+                ++starts.back();
+            } // end if (j != i && ...)
+        } // end for (int j = 1)
+    } // end for (int i = 1)
+
+    good = output.write(lengths.data(), lengths.size() * sizeof(uint32_t)) &&
+           output.write(text.str().data(), text.str().size()) &&
+           output.write(starts.data(), starts.size() * sizeof(int)) &&
+           output.write(pairs.data(), pairs.size() * sizeof(int));
+
+    if (withPaths)
+    {
+        good = good && output.write(rows.data(), rows.size());
+        paths.resize(2 * size);
+
+        for (int i = 1; good && i <= size; ++i)
+        {
+            int row = inner(i);
+
+            for (int j = 1; j <= size; ++j)
+            {
+                paths[j - 1] = Tdist[cell(row, inner(j))];
+                paths[size + j - 1] = outer(Tpath[cell(row, inner(j))]);
+            } // end for (int j = 1)
+
+            good = output.write(paths.data(), paths.size() * sizeof(int));
+        } // end for (int i = 1)
+    } // end if (withPaths)
+
+    memset(&header, 0, sizeof(header));
+    header.costWidth = sizeof(int);
+    header.nodes = size;
+    header.flags = (withPaths ? SNAPPATHS : 0);
+    header.edges = pairs.size() / 2;
+    header.textBytes = text.str().size();
+
+    return good && output.finish(header);
+} // end saveSnapshot(const char*, bool)
+
+/**---------------------- savePaths() -----------------------------------------
+ * Finds the shortest paths between all pairs of nodes and writes them to a
+ * path file, without using the path matrix; see PathFile. Memory for the
+ * search is bounded by one block of rows, however many nodes there are, and
+ * PathFile::open() then serves the paths a row at a time. A renumbered graph
+ * is written with its input numbers. The paths match those display() prints.
+ * @param name  The path of the file to write.
+ * @param narrow  true to store distances and nodes in two bytes wherever
+ *                every value in the file fits.
+ * @pre None.
+ * @post The out-edge and in-edge lists match the cost matrix. The file holds
+ *       every shortest path of this graph.
+ * @return true if the file was written in full; false, otherwise.
+ */
+bool GraphM::savePaths(const char* name, bool narrow)
+{
+    vector<int> start(size + 2, 0);     // edges by input number, each list
+    vector<int> dest;                   //  in order of destination as
+    vector<int> cost;                   //  buildEdges() makes them
+
+    if (!edged)
+    {
+        buildEdges();
+    } // end if (!edged)
+
+    if (innerOf.empty())
+    {
+        return PathFile::write(name, size, edgeStart, edgeDest, edgeCost,
+                               narrow, threads);
+    } // end if (innerOf.empty())
+
+    for (int i = 1; i <= size; ++i)
+    {
+        const int* costs = &C[cell(inner(i), 0)];   // cost matrix row for i
+
+        start[i] = dest.size();
+
+        for (int j = 1; j <= size; ++j)
+        {
+            if (j != i && costs[inner(j)] < INT_MAX)
+            {
+                dest.push_back(j);
+                cost.push_back(costs[inner(j)]);
+            } // end if (j != i && ...)
+        } // end for (int j = 1)
+    } // end for (int i = 1)
+
+    start[size + 1] = dest.size();
+    return PathFile::write(name, size, start, dest, cost, narrow, threads);
+} // end savePaths(const char*, bool)
+
+/**---------------------- loadSnapshot() --------------------------------------
+ * Replaces this graph with one read from a snapshot written by
+ * saveSnapshot(). If the snapshot holds the path matrix, the rows that were
+ * current when it was saved are current again and need not be found. Every
+ * edge and stored row is checked first, so a damaged file cannot lead a
+ * later walk along a path out of bounds or around a loop.
+ * @param name  The path of the file to read.
+ * @pre None.
+ * @post If the snapshot is complete, undamaged and of this version and cost
+ *       width, this graph represents it. Otherwise this graph is unchanged.
+ * @return true if the snapshot was loaded; false, otherwise.
+ */
+bool GraphM::loadSnapshot(const char* name)
+{
+    SnapshotReader  input(name);
+    const uint32_t* lengths;
+    const char*     text;
+    const int*      starts;
+    const int*      pairs;
+    const char*     rows = NULL;        // which rows of the path matrix
+    const int*      paths = NULL;       //  are current, and the rows
+    int             nodes = input.header().nodes;
+    uint64_t        textBytes = 0;
+
+    if (!input.valid() || input.header().costWidth != sizeof(int) ||
+        nodes < 0 || input.header().edges > (uint64_t)nodes * nodes)
+    {
+        return false;
+    } // end if (!input.valid() || ...)
+
+    lengths = static_cast<const uint32_t*>(
+                  input.take(nodes * sizeof(uint32_t)));
+    text = static_cast<const char*>(input.take(input.header().textBytes));
+    starts = static_cast<const int*>(input.take((nodes + 1) * sizeof(int)));
+    pairs = static_cast<const int*>(
+                input.take(input.header().edges * 2 * sizeof(int)));
+
+    if (input.header().flags & SNAPPATHS)
+    {
+        rows = static_cast<const char*>(input.take(nodes + 1));
+        paths = static_cast<const int*>(
+                    input.take((size_t)nodes * nodes * 2 * sizeof(int)));
+    } // end if (input.header().flags & SNAPPATHS)
+
+    if (lengths == NULL || text == NULL || starts == NULL || pairs == NULL ||
+        ((input.header().flags & SNAPPATHS) && paths == NULL) ||
+        starts[0] != 0 || (uint64_t)starts[nodes] != input.header().edges)
+    {
+        return false;
+    } // end if (lengths == NULL || ...)
+
+    for (int i = 0; i < nodes; ++i)     // every count and edge in range
+    {
+        textBytes += lengths[i];
+
+        if (starts[i + 1] < starts[i])
+        {
+            return false;
+        } // end if (starts[i + 1] < starts[i])
+
+        for (int e = starts[i]; e < starts[i + 1]; ++e)
+        {
+            if (pairs[2 * e] < 1 || pairs[2 * e] > nodes ||
+                pairs[2 * e] == i + 1 || pairs[2 * e + 1] < 1)
+            {
+                return false;
+            } // end if (pairs[2 * e] < 1 || ...)
+        } // end for (int e = starts[i])
+    } // end for (int i = 0)
+
+    if (textBytes != input.header().textBytes)
+    {
+        return false;
+    } // end if (textBytes != input.header().textBytes)
+
+    for (int i = 1; rows != NULL && i <= nodes; ++i)
+    {
+        if (rows[i] && !pathRowValid(paths + (size_t)(i - 1) * nodes * 2,
+                                     nodes, i))
+        {
+            return false;
+        } // end if (rows[i] && ...)
+    } // end for (int i = 1)
+
+    sizeGraph(nodes);
+    edges = input.header().edges;
+
+    for (int i = 1; i <= size; ++i)
+    {
+        names.add(string(text, lengths[i - 1]));
+        text += lengths[i - 1];
+
+        for (int e = starts[i - 1]; e < starts[i]; ++e)
+        {
+            C[cell(i, pairs[2 * e])] = pairs[2 * e + 1];
+            maxCost = max(maxCost, pairs[2 * e + 1]);
+        } // end for (int e = starts[i - 1])
+
+        if (rows != NULL && rows[i])
+        {
+            const int* row = paths + (size_t)(i - 1) * size * 2;
+
+            copy(row, row + size, &Tdist[cell(i, 1)]);
+            copy(row + size, row + 2 * size, &Tpath[cell(i, 1)]);
+            pathed[i] = true;
+        } // end if (rows != NULL && rows[i])
+    } // end for (int i = 1)
+
+    return true;
+} // end loadSnapshot(const char*)
+
+/**---------------------- reorder() -------------------------------------------
+ * Renumbers the nodes of this graph inside it so that nodes joined by edges
+ * sit near each other in the matrixes and edge lists, which keeps searches
+ * within fewer cache lines on a large graph. Every method still takes and
+ * gives the input numbers, and every report reads as before, though among
+ * paths of equal length the one chosen may differ, as ties go to the lower
+ * internal number. INPUT_ORDER undoes any renumbering, and does nothing to a
+ * graph that has none. Reordering is meant for just after the graph is
+ * built, as all paths must be found again.
+ * @param order  The numbering to use; see orderNodes().
+ * @pre None.
+ * @post The nodes are numbered by order inside this graph. If any were
+ *       renumbered, no row of the path matrix is current.
+ */
+void GraphM::reorder(NodeOrder order)
+{
+    vector<int> perm;                   // present number of each new number
+    vector<int> renumber(size + 1, 0);  // new number of each present number
+    vector<int> input(size + 1, 0);     // input number of each new number
+
+    if (order == INPUT_ORDER && innerOf.empty())
+    {
+        return;
+    } // end if (order == INPUT_ORDER && innerOf.empty())
+
+    if (!edged)
+    {
+        buildEdges();
+    } // end if (!edged)
+
+    if (order == INPUT_ORDER && !innerOf.empty())
+    {
+        perm = innerOf;
+    }
+    else
+    {
+        perm = orderNodes(order, size, edgeStart, edgeDest);
+    } // end if (order == INPUT_ORDER && !innerOf.empty())
+
+    for (int k = 1; k <= size; ++k)
+    {
+        renumber[perm[k]] = k;
+        input[k] = outer(perm[k]);
+    } // end for (int k = 1)
+
+    innerOf.clear();
+    outerOf.clear();
+
+    if (order != INPUT_ORDER)
+    {
+        outerOf.swap(input);
+        innerOf.assign(size + 1, 0);
+
+        for (int k = 1; k <= size; ++k)
+        {
+            innerOf[outerOf[k]] = k;
+        } // end for (int k = 1)
+    } // end if (order != INPUT_ORDER)
+
+    C.assign(cell(size + 1, 0), INT_MAX);   // refilled from the edge lists
+
+    for (int k = 1; k <= size; ++k)
+    {
+        C[cell(k, k)] = 0;
+
+        for (int e = edgeStart[perm[k]]; e < edgeStart[perm[k] + 1]; ++e)
+        {
+            C[cell(k, renumber[edgeDest[e]])] = edgeCost[e];
+        } // end for (int e = edgeStart[perm[k]])
+    } // end for (int k = 1)
+
+    Tdist.assign(cell(size + 1, 0), INT_MAX);
+    Tpath.assign(cell(size + 1, 0), 0);
+    pathed.assign(size + 1, false);
+    edged = false;
+    ranked = false;
+    hotPaths.clear();
+} // end reorder(NodeOrder)
+
+/**---------------------- insertEdge() ----------------------------------------
+ * Inserts a single edge into the graph between two existing nodes.
+ * @param source  The node from which to start the edge.
+ * @param dest  The adjacent node at which to end the edge.
+ * @param cost  The cost of the edge between the nodes.
+ * @pre source and dest are within the limits of the adjacency matrix; cost is
+ *      positive.
+ * @post The edge now exists in this graph. Any shortest paths found have been
+ *       repaired to account for it, or are no longer valid if repair is off.
+ * @return true if the input was valid and the edge could be added; false,
+ *         otherwise.
+ */
+bool GraphM::insertEdge(int source, int dest, int cost)
+{
+    bool success = (source > 0 && source <= size && cost > 0 &&     // validate
+                    dest > 0 && dest <= size && source != dest);    //  input
+
+    if (success)    // input is within matrix bounds
+    {
+        source = inner(source);
+        dest = inner(dest);
+
+        int oldCost = C[cell(source, dest)];
+
+        C[cell(source, dest)] = cost;         // update cell with cost
+        edges += (oldCost == INT_MAX);
+        maxCost = max(maxCost, cost);
+        repairPaths(source, dest, oldCost);
+        edged = false;
+        ranked = false;
+    } // end if (success)
+
+    return success;
+} // end insertEdge(int, int, int)
+
+/**---------------------- sizeGraph() -----------------------------------------
+ * Empties this graph and sizes it for a number of nodes. Each row of the
+ * matrixes is padded to a whole number of cache lines.
+ * @param nodes  The number of nodes the graph will hold.
+ * @pre nodes is not negative.
+ * @post This graph has nodes nodes and no edges, and no row of the path
+ *       matrix is current. The caller adds the nodes' descriptions to names
+ *       in order.
+ */
+void GraphM::sizeGraph(int nodes)
+{
+    size = nodes;
+    stride = (size + 1 + ROWINTS - 1) / ROWINTS * ROWINTS;
+    names.clear();
+    names.reserve(size);
+    C.assign(cell(size + 1, 0), INT_MAX);       // empty adjacency matrix
+    Tdist.assign(cell(size + 1, 0), INT_MAX);   // no known paths
+    Tpath.assign(cell(size + 1, 0), 0);
+    pathed.assign(size + 1, false);
+    edges = 0;
+    edged = false;
+    ranked = false;
+    maxCost = 0;
+    hotPaths.clear();
+    innerOf.clear();
+    outerOf.clear();
+
+    for (int i = 1; i <= size; ++i)
+    {
+        C[cell(i, i)] = 0;              // node distance to self is zero
+    } // end for (int i = 1)
+} // end sizeGraph(int)
+
+/**---------------------- inner() ---------------------------------------------
+ * Turns an input node number into the number this graph uses inside.
+ * @param id  The input number.
+ * @pre None.
+ * @post None.
+ * @return The inside number; id itself if the graph is not renumbered or id
+ *         is not a node.
+ */
+int GraphM::inner(int id) const
+{
+    return (innerOf.empty() || id < 1 || id > size) ? id : innerOf[id];
+} // end inner(int)
+
+/**---------------------- outer() ---------------------------------------------
+ * Turns a node number used inside this graph into its input number.
+ * @param v  The inside number.
+ * @pre None.
+ * @post None.
+ * @return The input number; v itself if the graph is not renumbered or v is
+ *         not a node.
+ */
+int GraphM::outer(int v) const
+{
+    return (outerOf.empty() || v < 1 || v > size) ? v : outerOf[v];
+} // end outer(int)
+
+/**---------------------- outerPath() -----------------------------------------
+ * Turns the inside numbers in a list of nodes into input numbers.
+ * @param nodes  The list to convert in place.
+ * @pre None.
+ * @post Every node in the list is given by its input number.
+ */
+void GraphM::outerPath(vector<int>& nodes) const
+{
+    if (!outerOf.empty())
+    {
+        for (int i = 0; i < (int)nodes.size(); ++i)
+        {
+            nodes[i] = outerOf[nodes[i]];
+        } // end for (int i = 0)
+    } // end if (!outerOf.empty())
+} // end outerPath(vector<int>&)
+
+/**---------------------- loadEdge() ------------------------------------------
+ * Inserts a single edge while the graph is being read. No shortest paths are
+ * known yet, so unlike insertEdge() there is nothing to repair.
+ * @param source  The node from which to start the edge.
+ * @param dest  The adjacent node at which to end the edge.
+ * @param cost  The cost of the edge between the nodes.
+ * @pre No row of the path matrix is current.
+ * @post The edge now exists in this graph.
+ * @return true if the input was valid; false, otherwise.
+ */
+bool GraphM::loadEdge(int source, int dest, int cost)
+{
+    bool success = (source > 0 && source <= size && cost > 0 &&     // validate
+                    dest > 0 && dest <= size && source != dest);    //  input
+
+    if (success)    // input is within matrix bounds
+    {
+        edges += (C[cell(source, dest)] == INT_MAX);
+        C[cell(source, dest)] = cost;
+        maxCost = max(maxCost, cost);
+    } // end if (success)
+
+    return success;
+} // end loadEdge(int, int, int)
+
+/**---------------------- removeEdge() ----------------------------------------
+ * Removes a single existing edge from the graph.
+ * @param source  The node from which the edge starts.
+ * @param dest  The adjacent node at which the edge ends.
+ * @pre The specified edge exists within this graph.
+ * @post The edge is removed from this graph. Any shortest paths found have
+ *       been repaired to account for it, or are no longer valid if repair is
+ *       off.
+ * @return true if the input was valid and the edge is now not in the graph;
+ *         false, otherwise.
+ */
+bool GraphM::removeEdge(int source, int dest)
+{
+    bool success = (source > 0 && source <= size &&         // validate input
+                    dest > 0 && dest <=size && source != dest);
+
+    if (success)    // input is within matrix bounds
+    {
+        source = inner(source);
+        dest = inner(dest);
+
+        int oldCost = C[cell(source, dest)];
+
+        C[cell(source, dest)] = INT_MAX;      // update cell to infinity
+        edges -= (oldCost != INT_MAX);
+        repairPaths(source, dest, oldCost);
+        edged = false;
+        ranked = false;
+    } // end if (success)
+
+    return success;
+} // end removeEdge(int, int)
+
+/**---------------------- repairPaths() --------------------------------------
+ * Brings the path matrix up to date after the cost of one edge has changed.
+ * Only the rows and nodes that the change can affect are visited: a cheaper
+ * edge relaxes outward from its destination, while a dearer or removed edge
+ * recomputes only the nodes whose shortest paths ran through it. Every
+ * predecessor is chosen by the same rule the full search follows, so the
+ * path matrix matches a full recompute exactly. Rows that are not current
+ * are left for the next search. Rows the change cannot reach, because a
+ * cheaper edge shortens no path in them or a dearer one is not in their
+ * tree, are skipped outright, and when fewer than REPAIRROWS rows are left,
+ * they are repaired on the calling thread rather than starting workers. If repair is off, every row is marked as not
+ * current instead. Either way, the cache of extracted paths is emptied.
+ * @param source  The node from which the changed edge starts.
+ * @param dest  The node at which the changed edge ends.
+ * @param oldCost  The cost of the edge before the change.
+ * @pre The cost matrix holds the new cost of the edge.
+ * @post Each row of the path matrix is current or is marked as not current.
+ */
+void GraphM::repairPaths(int source, int dest, int oldCost)
+{
+    int newCost = C[cell(source, dest)];
+    STATS_TIME(counters.repairNs);
+
+    hotPaths.clear();                   // any kept path may have changed
+
+    if (!repair)
+    {
+        STATS_ADD(counters.invalidated,
+                  count(pathed.begin() + 1, pathed.end(), true));
+        pathed.assign(size + 1, false);
+    }
+    else if (newCost != oldCost)
+    {
+        vector<int> rows;               // current rows the change reaches
+
+        for (int row = 1; row <= size; ++row)
+        {
+            const int* dist = &Tdist[cell(row, 0)];
+
+            if (!pathed[row])           // row will be found from scratch
+            {
+                continue;
+            } // end if (!pathed[row])
+
+            STATS_ADD(counters.repaired, 1);
+
+            if (newCost < oldCost ? dist[source] < INT_MAX &&
+                                    (long long)dist[source] + newCost <=
+                                    dist[dest]
+                                  : Tpath[cell(row, dest)] == source)
+            {
+                rows.push_back(row);
+            } // end if (newCost < oldCost ? ...)
+        } // end for (int row = 1)
+
+        function<void(int)> fixRow = [&](int i)
+        {
+            if (newCost < oldCost)
+            {
+                lowerCost(rows[i], source, dest);
+            }
+            else
+            {
+                raiseCost(rows[i], source, dest);
+            } // end if (newCost < oldCost)
+        };
+
+        if (threads == 1 || (int)rows.size() < REPAIRROWS)
+        {
+            for (int i = 0; i < (int)rows.size(); ++i)
+            {
+                fixRow(i);
+            } // end for (int i = 0)
+        }
+        else
+        {
+            WorkPool pool(threads);
+            pool.run(0, (int)rows.size() - 1, fixRow);
+        } // end if (threads == 1 || ...)
+    } // end if (!repair)
+} // end repairPaths(int, int, int)
+
+/**---------------------- lowerCost() -----------------------------------------
+ * Repairs one row of the path matrix after the edge (u, v) became cheaper or
+ * was added. Distances can only shrink, and only for nodes reached through
+ * the edge, so a search is started at v and spreads only while it improves.
+ * @param source  The row of the path matrix to repair.
+ * @param u  The node from which the changed edge starts.
+ * @param v  The node at which the changed edge ends.
+ * @pre The row was valid before the edge changed.
+ * @post The row holds all shortest paths from source.
+ */
+void GraphM::lowerCost(int source, int u, int v)
+{
+    int*     dist = &Tdist[cell(source, 0)];    // path matrix row for source
+    int*     path = &Tpath[cell(source, 0)];
+    PathHeap heap;                              // (dist, node) pairs
+    uint64_t shortened = 0;                     // paths relax() shortened
+    int x, length;
+    STATS_LOCAL(settled);
+
+    if (dist[u] < INT_MAX)
+    {
+        relax(dist, path, u, v, dist[u] + C[cell(u, v)], heap, shortened);
+    } // end if (dist[u] < INT_MAX)
+
+    while(!heap.empty())
+    {
+        x = heap.top().second;
+        length = heap.top().first;
+        heap.pop();
+
+        if (length == dist[x])      // skip entries made stale by relaxation
+        {
+            const int* costs = &C[cell(x, 0)];  // cost matrix row for x
+
+            STATS_ADD(settled, 1);
+
+            for (int w = 1; w <= size; ++w)
+            {
+                if (w != x && costs[w] < INT_MAX)
+                {
+                    relax(dist, path, x, w, length + costs[w], heap,
+                          shortened);
+                } // end if (w != x && costs[w] < INT_MAX)
+            } // end for (int w = 1)
+        } // end if (length == dist[x])
+    } // end while(!heap.empty())
+
+    STATS_ADD(counters.settled, settled);
+    STATS_ADD(counters.scanned, settled * size);
+    STATS_ADD(counters.relaxations, shortened);
+} // end lowerCost(int, int, int)
+
+/**---------------------- raiseCost() -----------------------------------------
+ * Repairs one row of the path matrix after the edge (u, v) became dearer or
+ * was removed. If the edge is not in the row's tree of shortest paths,
+ * nothing changes. Otherwise, the nodes below v in that tree are reset and
+ * found again, starting from their cheapest entries from the rest of the
+ * tree.
+ * @param source  The row of the path matrix to repair.
+ * @param u  The node from which the changed edge starts.
+ * @param v  The node at which the changed edge ends.
+ * @pre The row was valid before the edge changed.
+ * @post The row holds all shortest paths from source.
+ */
+void GraphM::raiseCost(int source, int u, int v)
+{
+    int*        dist = &Tdist[cell(source, 0)]; // path matrix row for source
+    int*        path = &Tpath[cell(source, 0)];
+    PathHeap    heap;                           // (dist, node) pairs
+    vector<int> tree;                           // nodes that used (u, v)
+    uint64_t    shortened = 0;                  // paths relax() shortened
+    int x, length;
+    STATS_LOCAL(settled);
+
+    if (path[v] != u)           // edge was not on any shortest path
+    {
+        return;
+    } // end if (path[v] != u)
+
+    tree.push_back(v);
+
+    for (int i = 0; i < (int)tree.size(); ++i)  // gather the subtree of v
+    {
+        for (int w = 1; w <= size; ++w)
+        {
+            if (path[w] == tree[i])
+            {
+                tree.push_back(w);
+            } // end if (path[w] == tree[i])
+        } // end for (int w = 1)
+    } // end for (int i = 0)
+
+    for (int i = 0; i < (int)tree.size(); ++i)
+    {
+        dist[tree[i]] = INT_MAX;        // forget the old path
+        path[tree[i]] = 0;
+    } // end for (int i = 0)
+
+    for (int i = 0; i < (int)tree.size(); ++i)  // enter from outside subtree
+    {
+        x = tree[i];
+
+        for (int y = 1; y <= size; ++y)
+        {
+            if (y != x && dist[y] < INT_MAX && C[cell(y, x)] < INT_MAX)
+            {
+                relax(dist, path, y, x, dist[y] + C[cell(y, x)], heap,
+                      shortened);
+            } // end if (y != x && ...)
+        } // end for (int y = 1)
+    } // end for (int i = 0)
+
+    while(!heap.empty())
+    {
+        x = heap.top().second;
+        length = heap.top().first;
+        heap.pop();
+
+        if (length == dist[x])      // skip entries made stale by relaxation
+        {
+            const int* costs = &C[cell(x, 0)];  // cost matrix row for x
+
+            STATS_ADD(settled, 1);
+
+            for (int w = 1; w <= size; ++w)
+            {
+                if (w != x && costs[w] < INT_MAX)
+                {
+                    relax(dist, path, x, w, length + costs[w], heap,
+                          shortened);
+                } // end if (w != x && costs[w] < INT_MAX)
+            } // end for (int w = 1)
+        } // end if (length == dist[x])
+    } // end while(!heap.empty())
+
+    STATS_ADD(counters.settled, settled);
+    STATS_ADD(counters.scanned, (tree.size() * 2 + settled) * size);
+    STATS_ADD(counters.relaxations, shortened);
+} // end raiseCost(int, int, int)
+
+/**---------------------- relax() ---------------------------------------------
+ * Offers a path to w through v during a repair. A shorter path replaces the
+ * current one and queues w. A path of equal length replaces the current one
+ * only if v would have been visited first by a full search, that is, if v is
+ * closer to the source or equally close and lower numbered.
+ * @param dist  The distances in the row of the path matrix being repaired.
+ * @param path  The previous nodes in the same row.
+ * @param v  The node through which the path reaches w.
+ * @param w  The node at which the path ends.
+ * @param length  The length of the path.
+ * @param heap  The nodes waiting to be visited.
+ * @param shortened  Counts the paths shortened, with GRAPH_STATS; the
+ *                   caller adds it to the shared counters once per row.
+ * @pre The distance to v is final.
+ * @post The row holds the better of the two paths to w.
+ */
+void GraphM::relax(int* dist, int* path, int v, int w, int length,
+                   PathHeap& heap, uint64_t& shortened)
+{
+    if (length < dist[w])
+    {
+        dist[w] = length;
+        path[w] = v;
+        heap.push(make_pair(length, w));
+        STATS_ADD(shortened, 1);
+    }
+    else if (length == dist[w] && precedes(dist, v, path[w]))
+    {
+        path[w] = v;
+    } // end if (length < dist[w])
+
+    (void)shortened;            // counted only with GRAPH_STATS
+} // end relax(int*, int*, int, int, int, PathHeap&, uint64_t&)
+
+/**---------------------- precedes() ------------------------------------------
+ * Determines whether a full search would visit one node before another.
+ * @param dist  The distances in the row of the path matrix being searched.
+ * @param v  The node in question.
+ * @param w  The node to compare against; 0 for none.
+ * @pre None.
+ * @post None.
+ * @return true if v is closer to the source than w, or equally close and
+ *         lower numbered, or if w is 0; false, otherwise.
+ */
+bool GraphM::precedes(const int* dist, int v, int w) const
+{
+    return w == 0 || dist[v] < dist[w] || (dist[v] == dist[w] && v < w);
+} // end precedes(const int*, int, int)
+
+/**---------------------- findShortestPath() ----------------------------------
+ * Uses Dijkstra's Algorithm to find the shortes paths from every node to every
+ * other node. A path matrix is used to store path descriptions. The engine
+ * selected with setEngine() determines how each source is processed; all
+ * engines produce the same path matrix. Each source fills only its own row of
+ * the path matrix, so when more than one thread is allowed the sources are
+ * spread over a pool of workers; the result is identical to a serial run.
+ * Rows that are already current are not searched again. When most rows are
+ * stale, the Floyd-Warshall engine may instead redo the whole matrix at once.
+ * @pre The graph is not empty.
+ * @post All shortest paths are represented in the path matrix. Every row is
+ *       flagged as current.
+ */
+void GraphM::findShortestPath(void)
+{
+    int stale = 0;      // rows that need to be found
+    STATS_TIME(counters.pathNs);
+
+    for (int source = 1; source <= size; ++source)
+    {
+        stale += !pathed[source];
+    } // end for (int source = 1)
+
+    STATS_ADD(counters.cacheHits, size - stale);
+
+    if (stale == 0)
+    {
+        return;
+    }
+    else if (useFloyd(stale))
+    {
+        floydAll();
+        return;
+    } // end if (stale == 0)
+
+    if (rowEngine() != MATRIX_SCAN && !edged)
+    {
+        buildEdges();
+    } // end if (rowEngine() != MATRIX_SCAN && !edged)
+
+    function<void(int)> findRow = [this](int source)
+    {
+        if (!pathed[source])
+        {
+            findPathsFrom(source);
+        } // end if (!pathed[source])
+    };
+
+    if (threads == 1)
+    {
+        for (int source = 1; source <= size; ++source)
+        {
+            findRow(source);
+        } // end for (int source = 1)
+    }
+    else
+    {
+        WorkPool pool(threads);
+        pool.run(1, size, findRow);
+    } // end if (threads == 1)
+} // end findShortestPath()
+
+/**---------------------- findShortestPath() ----------------------------------
+ * Finds the shortest paths from a single node to every other node, leaving
+ * the other rows of the path matrix alone. The row is kept until an edge
+ * change makes it stale, so repeated queries from the same node search only
+ * once.
+ * @param source  The node from which to find paths.
+ * @pre source is a node in this graph.
+ * @post The row of the path matrix for source is current.
+ */
+void GraphM::findShortestPath(int source)
+{
+    STATS_TIME(counters.pathNs);
+
+    source = inner(source);
+
+    if (pathed[source])
+    {
+        STATS_ADD(counters.cacheHits, 1);
+    }
+    else
+    {
+        if (rowEngine() != MATRIX_SCAN && !edged)
+        {
+            buildEdges();
+        } // end if (rowEngine() != MATRIX_SCAN && !edged)
+
+        findPathsFrom(source);
+    } // end if (pathed[source])
+} // end findShortestPath(int)
+
+/**---------------------- queryPath() -----------------------------------------
+ * Finds the shortest path between one pair of nodes without the path matrix,
+ * which is neither read nor changed. Two searches run at once, one forward
+ * from source over out-edges and one backward from dest over in-edges, each
+ * step taken by the side with fewer nodes waiting. Whenever an edge joins the
+ * two searches the best path through it is noted, and both stop once their
+ * nearest waiting nodes together are no closer than that path. On a large
+ * graph only the nodes near the two ends are settled. Among paths of equal
+ * length, the one returned may differ from the one display() prints.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @param nodes  Receives the nodes on the path, from source to dest; empty
+ *               if there is none.
+ * @pre None.
+ * @post The out-edge and in-edge lists match the cost matrix.
+ * @return The length of the path, or INT_MAX if there is none or either node
+ *         is not in this graph.
+ */
+int GraphM::queryPath(int source, int dest, vector<int>& nodes)
+{
+    PathHeap  heap[2];                  // forward and backward waiting nodes
+    long long best = LLONG_MAX;         // shortest joined path so far
+    int       meet = 0;                 // node where that path joins
+    uint64_t  shortened = 0;            // paths reach() kept
+    int side, v, w, length;
+    STATS_TIME(counters.pathNs);
+    STATS_LOCAL(settled);
+
+    nodes.clear();
+    source = inner(source);
+    dest = inner(dest);
+
+    if (source < 1 || source > size || dest < 1 || dest > size)
+    {
+        return INT_MAX;
+    } // end if (source < 1 || ...)
+
+    if (!edged)
+    {
+        buildEdges();
+    } // end if (!edged)
+
+    startQuery();
+    reach(0, source, 0, 0, heap[0], shortened);
+    reach(1, dest, 0, 0, heap[1], shortened);
+
+    if (source == dest)
+    {
+        best = 0;
+        meet = source;
+    } // end if (source == dest)
+
+    while(!heap[0].empty() && !heap[1].empty() &&
+          (long long)heap[0].top().first + heap[1].top().first < best)
+    {
+        side = (heap[0].size() <= heap[1].size()) ? 0 : 1;
+        v = heap[side].top().second;
+        length = heap[side].top().first;
+        heap[side].pop();
+
+        if (length != queryDist[side][v])   // made stale by relaxation
+        {
+            continue;
+        } // end if (length != queryDist[side][v])
+
+        STATS_ADD(settled, 1);
+
+        const vector<int>& start = (side == 0) ? edgeStart : inStart;
+        const vector<int>& next  = (side == 0) ? edgeDest : inSource;
+        const vector<int>& cost  = (side == 0) ? edgeCost : inCost;
+
+        for (int e = start[v]; e < start[v + 1]; ++e)
+        {
+            w = next[e];
+            reach(side, w, length + cost[e], v, heap[side], shortened);
+
+            if (reached(1 - side, w) &&
+                (long long)length + cost[e] + queryDist[1 - side][w] < best)
+            {
+                best = (long long)length + cost[e] + queryDist[1 - side][w];
+                meet = w;
+            } // end if (reached(1 - side, w) && ...)
+        } // end for (int e = start[v])
+    } // end while(!heap[0].empty() && ...)
+
+    STATS_ADD(counters.settled, settled);
+    STATS_ADD(counters.relaxations, shortened);
+
+    if (meet == 0)
+    {
+        return INT_MAX;
+    } // end if (meet == 0)
+
+    joinPath(meet, nodes);
+    outerPath(nodes);
+    return (int)best;
+} // end queryPath(int, int, vector<int>&)
+
+/**---------------------- queryPath() -----------------------------------------
+ * Finds the shortest path between one pair of nodes with the A* search,
+ * guided by a caller's estimate of the distance left to dest; for example,
+ * the straight-line distance between known coordinates of the nodes. Nodes
+ * are settled in order of their distance from source plus their estimate, so
+ * the search heads toward dest and stops as soon as dest is settled. Like
+ * the search without an estimate, it neither reads nor changes the path
+ * matrix.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @param nodes  Receives the nodes on the path, from source to dest; empty
+ *               if there is none.
+ * @param estimate  Gives, for a node, a lower bound on the length of the
+ *                  shortest path from it to dest. Estimates that are never
+ *                  too high give shortest paths; ones that also never drop
+ *                  by more than an edge's cost along it settle each node
+ *                  once.
+ * @pre estimate never returns a negative value.
+ * @post The out-edge and in-edge lists match the cost matrix.
+ * @return The length of the path, or INT_MAX if there is none or either node
+ *         is not in this graph.
+ */
+int GraphM::queryPath(int source, int dest, vector<int>& nodes,
+                      const function<int(int)>& estimate)
+{
+    PathHeap heap;                      // (dist + estimate, node) pairs
+    int v, w, guess;
+    STATS_TIME(counters.pathNs);
+    STATS_LOCAL(settled);
+
+    nodes.clear();
+    source = inner(source);
+    dest = inner(dest);
+
+    if (source < 1 || source > size || dest < 1 || dest > size)
+    {
+        return INT_MAX;
+    } // end if (source < 1 || ...)
+
+    if (!edged)
+    {
+        buildEdges();
+    } // end if (!edged)
+
+    startQuery();
+    queryMark[0][source] = queryId;
+    queryDist[0][source] = 0;
+    queryPrev[0][source] = 0;
+    heap.push(make_pair(estimate(outer(source)), source));
+
+    while(!heap.empty())
+    {
+        v = heap.top().second;
+        guess = heap.top().first;
+        heap.pop();
+
+        if (guess != queryDist[0][v] + estimate(outer(v)))  // stale entry
+        {
+            continue;
+        } // end if (guess != queryDist[0][v] + estimate(outer(v)))
+
+        STATS_ADD(settled, 1);
+
+        if (v == dest)
+        {
+            break;
+        } // end if (v == dest)
+
+        for (int e = edgeStart[v]; e < edgeStart[v + 1]; ++e)
+        {
+            w = edgeDest[e];
+
+            if (!reached(0, w) ||
+                queryDist[0][v] + edgeCost[e] < queryDist[0][w])
+            {
+                queryMark[0][w] = queryId;
+                queryDist[0][w] = queryDist[0][v] + edgeCost[e];
+                queryPrev[0][w] = v;
+                heap.push(make_pair(queryDist[0][w] + estimate(outer(w)),
+                                    w));
+            } // end if (!reached(0, w) || ...)
+        } // end for (int e = edgeStart[v])
+    } // end while(!heap.empty())
+
+    STATS_ADD(counters.settled, settled);
+
+    if (!reached(0, dest))
+    {
+        return INT_MAX;
+    } // end if (!reached(0, dest))
+
+    joinPath(dest, nodes);
+    outerPath(nodes);
+    return queryDist[0][dest];
+} // end queryPath(int, int, vector<int>&, const function<int(int)>&)
+
+/**---------------------- distanceTable() -------------------------------------
+ * Finds the lengths of the shortest paths from each of a list of origins to
+ * each of a list of targets, as a dense table. Once buildHierarchy() has
+ * run, the searches share their work through the hierarchy. See
+ * fillTable().
+ * @param origins  The nodes from which paths start; one row each.
+ * @param targets  The nodes at which paths end; one column each.
+ * @param table  Receives the length of each path, row by row; INT_MAX where
+ *               there is none or either node is not in this graph.
+ * @pre None.
+ * @post The out-edge and in-edge lists match the cost matrix.
+ */
+void GraphM::distanceTable(const vector<int>& origins,
+                           const vector<int>& targets, vector<int>& table)
+{
+    fillTable(origins, targets, table, NULL);
+} // end distanceTable(const vector<int>&, const vector<int>&, vector<int>&)
+
+/**---------------------- distanceTable() -------------------------------------
+ * Finds the lengths of the shortest paths from each of a list of origins to
+ * each of a list of targets, as a dense table, along with the node before
+ * each target on its path. See fillTable().
+ * @param origins  The nodes from which paths start; one row each.
+ * @param targets  The nodes at which paths end; one column each.
+ * @param table  Receives the length of each path, row by row; INT_MAX where
+ *               there is none or either node is not in this graph.
+ * @param previous  Receives the node before the target on each path, laid
+ *                  out as table is; 0 where there is none, or where the
+ *                  target is the origin.
+ * @pre None.
+ * @post The out-edge and in-edge lists match the cost matrix.
+ */
+void GraphM::distanceTable(const vector<int>& origins,
+                           const vector<int>& targets, vector<int>& table,
+                           vector<int>& previous)
+{
+    fillTable(origins, targets, table, &previous);
+} // end distanceTable(const vector<int>&, const vector<int>&, ...)
+
+/**---------------------- setEngine() -----------------------------------------
+ * Selects the algorithm used by findShortestPath(). MATRIX_SCAN finds each
+ * node to visit with a linear scan of the path matrix, which suits dense
+ * graphs. BINARY_HEAP keeps unvisited nodes in a heap and relaxes only the
+ * edges that exist, which suits sparse graphs. BUCKET_QUEUE does the same
+ * with one bucket per distance, which makes each step constant time when
+ * edge costs are small; if any edge costs more than BUCKETMAX it falls back
+ * to the heap. FLOYD_WARSHALL redoes the
+ * whole path matrix at once with cache-sized tiles and vector instructions,
+ * which suits dense graphs best of all; single rows are still found with
+ * Dijkstra's algorithm, as are all rows if a path could reach FLOYDINF.
+ * AUTO_ENGINE, the default, picks from the others by
+ * the size and density of the graph and the largest edge cost.
+ * @param newEngine  The algorithm to use from now on.
+ * @pre None.
+ * @post Later path searches use newEngine. Paths already found remain valid.
+ */
+void GraphM::setEngine(PathEngine newEngine)
+{
+    engine = newEngine;
+} // end setEngine(PathEngine)
+
+/**---------------------- setThreads() ----------------------------------------
+ * Sets the number of threads findShortestPath() may use.
+ * @param count  The number of threads. One runs every source on the calling
+ *               thread; less than one uses every hardware thread.
+ * @pre None.
+ * @post Later path searches use up to count threads.
+ */
+void GraphM::setThreads(int count)
+{
+    threads = count;
+} // end setThreads(int)
+
+/**---------------------- setRepair() -----------------------------------------
+ * Chooses how the path matrix reacts to insertEdge() and removeEdge(). When
+ * repair is on, valid paths are repaired in place; when it is off, they are
+ * discarded and the next search recomputes every path.
+ * @param enabled  Whether edge changes should repair the path matrix.
+ * @pre None.
+ * @post Later edge changes follow the chosen policy.
+ */
+void GraphM::setRepair(bool enabled)
+{
+    repair = enabled;
+} // end setRepair(bool)
+
+/**---------------------- buildHierarchy() ------------------------------------
+ * Builds the contraction hierarchy that routePath() searches. This is the
+ * slow step, done once for a graph; routePath() does it on first use if it
+ * has not been done, and again after any edge change.
+ * @pre None.
+ * @post The hierarchy matches the cost matrix.
+ */
+void GraphM::buildHierarchy(void)
+{
+    if (!edged)
+    {
+        buildEdges();
+    } // end if (!edged)
+
+    shortcuts.build(size, edgeStart, edgeDest, edgeCost);
+    ranked = true;
+} // end buildHierarchy()
+
+/**---------------------- routePath() -----------------------------------------
+ * Finds the shortest path between one pair of nodes with the contraction
+ * hierarchy, neither reading nor changing the path matrix. Once the
+ * hierarchy is built, each query settles only a few nodes even on a large
+ * graph, so this suits many queries between scattered pairs of nodes on a
+ * graph that seldom changes. Among paths of equal length, the one returned
+ * may differ from the one display() prints.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @param nodes  Receives the nodes on the path, from source to dest; empty
+ *               if there is none.
+ * @pre None.
+ * @post The hierarchy matches the cost matrix.
+ * @return The length of the path, or INT_MAX if there is none or either node
+ *         is not in this graph.
+ */
+int GraphM::routePath(int source, int dest, vector<int>& nodes)
+{
+    int length;
+    STATS_TIME(counters.pathNs);
+
+    if (!ranked)
+    {
+        buildHierarchy();
+    } // end if (!ranked)
+
+    length = shortcuts.query(inner(source), inner(dest), nodes);
+    outerPath(nodes);
+    return length;
+} // end routePath(int, int, vector<int>&)
+
+/**---------------------- hierarchy() -----------------------------------------
+ * Gives read access to the contraction hierarchy, for reporting its size.
+ * @pre None.
+ * @post None.
+ * @return The hierarchy; empty if it has not been built.
+ */
+const ContractionHierarchy& GraphM::hierarchy(void) const
+{
+    return shortcuts;
+} // end hierarchy()
+
+/**---------------------- setPathCache() --------------------------------------
+ * Sizes the cache of paths kept by extractPath() and display(). Paths asked
+ * for again while still in the cache are copied out rather than walked
+ * through the path matrix; when the cache is full, the least recently used
+ * path gives way. Any edge change empties the cache.
+ * @param entries  The most paths to keep; 0, the default, keeps none.
+ * @pre None.
+ * @post The cache is empty and keeps up to entries paths.
+ */
+void GraphM::setPathCache(int entries)
+{
+    hotPaths.resize(entries);
+} // end setPathCache(int)
+
+/**---------------------- findNode() ------------------------------------------
+ * Finds a node by its description through a hash index, so a query can be
+ * made by name, as in display(findNode("Woodland Park Zoo"), 1).
+ * @param description  The description to look for.
+ * @pre None.
+ * @post None.
+ * @return The lowest numbered node with that description; 0 if none has it.
+ */
+int GraphM::findNode(const string& description) const
+{
+    return names.find(description);
+} // end findNode(const string&)
+
+/**---------------------- stats() ---------------------------------------------
+ * Reports what the path searches, repairs and queries have done since the
+ * graph was created or resetStats() was last called. The counters only move
+ * when the program is built with GRAPH_STATS; they read zero otherwise.
+ * @pre None.
+ * @post None.
+ * @return The counters and phase timers of this graph.
+ */
+const PathStats& GraphM::stats(void) const
+{
+    return counters;
+} // end stats()
+
+/**---------------------- resetStats() ----------------------------------------
+ * Sets the counters and phase timers of this graph back to zero.
+ * @pre None.
+ * @post Every counter and timer is zero.
+ */
+void GraphM::resetStats(void)
+{
+    counters.reset();
+} // end resetStats()
+
+/**---------------------- findPathsFrom() -------------------------------------
+ * Finds the shortest paths from a single node with the selected engine.
+ * @param source  The node from which to find paths.
+ * @pre The out-edge lists match the cost matrix if the heap or bucket
+ *      engine is selected.
+ * @post The row of the path matrix for source holds all shortest paths and
+ *       is flagged as current.
+ */
+void GraphM::findPathsFrom(int source)
+{
+    fill(Tdist.begin() + cell(source, 0), Tdist.begin() + cell(source + 1, 0),
+         INT_MAX);                      // no known paths
+    fill(Tpath.begin() + cell(source, 0), Tpath.begin() + cell(source + 1, 0),
+         0);
+
+    switch (rowEngine())
+    {
+        case BINARY_HEAP:
+            heapPath(source);
+            break;
+        case BUCKET_QUEUE:
+            bucketPath(source);
+            break;
+        default:
+            scanPath(source);
+            break;
+    } // end switch (rowEngine())
+
+    pathed[source] = true;
+    STATS_ADD(counters.recomputed, 1);
+} // end findPathsFrom(int)
+
+/**---------------------- rowEngine() -----------------------------------------
+ * Chooses the algorithm used to find the paths from a single node. For
+ * AUTO_ENGINE and FLOYD_WARSHALL, edge lists are walked unless the graph is
+ * so dense that walking its edges costs more than scanning whole rows. Edge
+ * lists are walked with buckets if no edge costs more than BUCKETMAX and
+ * with the heap otherwise; BUCKET_QUEUE falls back to the heap the same way.
+ * @pre None.
+ * @post None.
+ * @return MATRIX_SCAN, BINARY_HEAP or BUCKET_QUEUE.
+ */
+PathEngine GraphM::rowEngine(void) const
+{
+    PathEngine lists = (maxCost <= BUCKETMAX) ? BUCKET_QUEUE : BINARY_HEAP;
+
+    if (engine == MATRIX_SCAN || engine == BINARY_HEAP)
+    {
+        return engine;
+    }
+    else if (engine == BUCKET_QUEUE)
+    {
+        return lists;
+    } // end if (engine == MATRIX_SCAN || engine == BINARY_HEAP)
+
+    return (100LL * edges < (long long)size * size * SCANPERCENT) ?
+           lists : MATRIX_SCAN;
+} // end rowEngine()
+
+/**---------------------- useFloyd() ------------------------------------------
+ * Decides whether findShortestPath() should redo the whole path matrix with
+ * the Floyd-Warshall engine. Under AUTO_ENGINE this happens only when most
+ * rows are stale and the graph is big and dense enough for the tiled engine
+ * to beat a search from every stale row. The engine cannot hold a path of
+ * FLOYDINF or more, so it is never used, even when selected, if edges cost
+ * enough that such a path might exist.
+ * @param stale  The number of rows that need to be found.
+ * @pre None.
+ * @post None.
+ * @return true if the Floyd-Warshall engine should be used; false, otherwise.
+ */
+bool GraphM::useFloyd(int stale) const
+{
+    if ((long long)maxCost * (size - 1) >= FLOYDINF)
+    {
+        return false;
+    } // end if ((long long)maxCost * (size - 1) >= FLOYDINF)
+
+    if (engine != AUTO_ENGINE)
+    {
+        return engine == FLOYD_WARSHALL;
+    } // end if (engine != AUTO_ENGINE)
+
+    return 2 * stale > size && size >= FLOYDMIN &&
+           100LL * edges >= (long long)size * size * FLOYDPERCENT;
+} // end useFloyd(int)
+
+/**---------------------- floydAll() ------------------------------------------
+ * Finds every row of the path matrix with the tiled Floyd-Warshall engine,
+ * then recovers the previous node on each path so the path matrix matches
+ * the one Dijkstra's algorithm would build.
+ * @pre Edge costs and path lengths are less than FLOYDINF.
+ * @post All shortest paths are represented in the path matrix. Every row is
+ *       flagged as current.
+ */
+void GraphM::floydAll(void)
+{
+    int         tiled = floydStride(size);  // row length of tiled matrixes
+    vector<int> cost((size_t)tiled * tiled, FLOYDINF), dist;
+    WorkPool    pool(threads);
+
+    for (int v = 1; v <= size; ++v)     // copy C into a padded matrix
+    {
+        for (int w = 1; w <= size; ++w)
+        {
+            if (C[cell(v, w)] < INT_MAX)
+            {
+                cost[(size_t)(v - 1) * tiled + w - 1] = C[cell(v, w)];
+            } // end if (C[cell(v, w)] < INT_MAX)
+        } // end for (int w = 1)
+    } // end for (int v = 1)
+
+    dist = cost;
+    floydWarshall(&dist[0], size, tiled, threads == 1 ? NULL : &pool);
+
+    function<void(int)> findRow = [&](int source)
+    {
+        int*        rowDist = &Tdist[cell(source, 0)];  // path matrix row
+        int*        rowPath = &Tpath[cell(source, 0)];
+        const int*  found = &dist[(size_t)(source - 1) * tiled];
+        vector<int> order(size), path(tiled);
+
+        floydPaths(&dist[0], &cost[0], size, tiled, source - 1, &order[0],
+                   &path[0]);
+        rowDist[0] = INT_MAX;
+        rowPath[0] = 0;
+
+        for (int w = 1; w <= size; ++w)
+        {
+            rowDist[w] = (found[w - 1] < FLOYDINF) ? found[w - 1] : INT_MAX;
+            rowPath[w] = path[w - 1];
+        } // end for (int w = 1)
+
+        pathed[source] = true;
+        STATS_ADD(counters.recomputed, 1);
+    };
+
+    if (threads == 1)
+    {
+        for (int source = 1; source <= size; ++source)
+        {
+            findRow(source);
+        } // end for (int source = 1)
+    }
+    else
+    {
+        pool.run(1, size, findRow);
+    } // end if (threads == 1)
+} // end floydAll()
+
+/**---------------------- scanPath() ------------------------------------------
+ * Finds the shortest paths from a single node by scanning the path matrix for
+ * the next node to visit and the cost matrix for its adjacent nodes. Visited
+ * nodes are tracked in a bitset that lives only as long as the search. Once
+ * no reachable node is left to visit, the search stops early.
+ * @param source  The node from which to find paths.
+ * @pre The row of the path matrix for source is reset.
+ * @post The row of the path matrix for source holds all shortest paths.
+ */
+void GraphM::scanPath(int source)
+{
+    vector<uint64_t> visited(stride / 64 + 1, 0);   // one bit per node
+    uint64_t         shortened = 0;                 // paths setW() shortened
+    int numVisits = 0, v;
+
+    Tdist[cell(source, source)] = 0;
+
+    while(numVisits < size)
+    {
+        v = findV(source, &visited[0]);
+
+        if (v == 0)         // every node left is unreachable
+        {
+            break;
+        } // end if (v == 0)
+
+        visited[v / 64] |= (uint64_t)1 << (v % 64);
+        ++numVisits;
+        setW(source, v, shortened);
+    } // end while(numVisits < size)
+
+    STATS_ADD(counters.settled, numVisits);     // a row of T per findV()
+    STATS_ADD(counters.scanned,                 //  and a row of C per setW()
+              (uint64_t)(2 * numVisits + 1) * stride);
+    STATS_ADD(counters.relaxations, shortened);
+} // end scanPath(int)
+
+/**---------------------- heapPath() ------------------------------------------
+ * Finds the shortest paths from a single node using a binary heap of
+ * (distance, node) pairs. Nodes are visited in the same order as findV()
+ * would choose them, with ties going to the lower numbered node, so the path
+ * matrix matches the one produced by scanPath(). The search itself is
+ * dijkstra(), which distance tables and path files share.
+ * @param source  The node from which to find paths.
+ * @pre The row of the path matrix for source is reset. The out-edge lists
+ *      match the cost matrix.
+ * @post The row of the path matrix for source holds all shortest paths.
+ */
+void GraphM::heapPath(int source)
+{
+    uint64_t settled = 0, shortened = 0;        // counts, with GRAPH_STATS
+
+    dijkstra(source, edgeStart.data(), edgeDest.data(), edgeCost.data(),
+             &Tdist[cell(source, 0)], &Tpath[cell(source, 0)], NULL,
+             [](int) { return true; }, settled, shortened);
+
+    STATS_ADD(counters.settled, settled);
+    STATS_ADD(counters.relaxations, shortened);
+} // end heapPath(int)
+
+/**---------------------- bucketPath() ----------------------------------------
+ * Finds the shortest paths from a single node with Dial's algorithm: nodes
+ * wait in one bucket per distance, and the buckets are emptied in order of
+ * distance. Since no edge costs more than maxCost, only maxCost + 1 buckets
+ * can be in use at once, so they are reused in a ring. Each bucket is sorted
+ * before it is emptied; nothing joins a bucket while it is emptied, as every
+ * cost is positive, so nodes are visited in the same order as heapPath()
+ * and the path matrix matches. A node whose distance no longer matches its
+ * bucket is stale and skipped.
+ * @param source  The node from which to find paths.
+ * @pre The row of the path matrix for source is reset. The out-edge lists
+ *      match the cost matrix, and maxCost is at most BUCKETMAX.
+ * @post The row of the path matrix for source holds all shortest paths.
+ */
+void GraphM::bucketPath(int source)
+{
+    vector<vector<int> > ring(maxCost + 1);     // bucket of each distance
+    int*  dist = &Tdist[cell(source, 0)];       // path matrix row for source
+    int*  path = &Tpath[cell(source, 0)];
+    long  waiting = 1;                          // nodes in any bucket
+    int v, w;
+    STATS_LOCAL(settled);
+    STATS_LOCAL(shortened);
+
+    dist[source] = 0;
+    ring[0].push_back(source);
+
+    for (int length = 0; waiting > 0; ++length)
+    {
+        vector<int>& bucket = ring[length % ring.size()];
+
+        waiting -= bucket.size();
+        sort(bucket.begin(), bucket.end());     // lowest numbered first
+
+        for (int i = 0; i < (int)bucket.size(); ++i)
+        {
+            v = bucket[i];
+
+            if (dist[v] != length)      // skip entries made stale
+            {
+                continue;
+            } // end if (dist[v] != length)
+
+            STATS_ADD(settled, 1);
+
+            for (int e = edgeStart[v]; e < edgeStart[v + 1]; ++e)
+            {
+                w = edgeDest[e];
+
+                if (dist[w] > length + edgeCost[e])
+                {
+                    dist[w] = length + edgeCost[e];
+                    path[w] = v;
+                    ring[dist[w] % ring.size()].push_back(w);
+                    ++waiting;
+                    STATS_ADD(shortened, 1);
+                } // end if (dist[w] > length + edgeCost[e])
+            } // end for (int e = edgeStart[v])
+        } // end for (int i = 0)
+
+        bucket.clear();
+    } // end for (int length = 0)
+
+    STATS_ADD(counters.settled, settled);
+    STATS_ADD(counters.relaxations, shortened);
+} // end bucketPath(int)
+
+/**---------------------- buildEdges() ----------------------------------------
+ * Builds lists of out-edges from the cost matrix. The edges leaving node v
+ * are stored at indexes edgeStart[v] through edgeStart[v + 1] - 1 of edgeDest
+ * and edgeCost, in order of destination. The in-edges are then gathered the
+ * same way: those entering node w are at inStart[w] through inStart[w + 1] - 1
+ * of inSource and inCost, in order of source. The largest cost is noted, since
+ * removing edges may have left maxCost higher than it needs to be.
+ * @pre None.
+ * @post The out-edge and in-edge lists match the cost matrix.
+ */
+void GraphM::buildEdges(void)
+{
+    edgeStart.assign(size + 2, 0);
+    edgeDest.clear();
+    edgeCost.clear();
+
+    for (int v = 1; v <= size; ++v)
+    {
+        const int* costs = &C[cell(v, 0)];  // cost matrix row for v
+        edgeStart[v] = edgeDest.size();
+
+        for (int w = 1; w <= size; ++w)
+        {
+            if (w != v && costs[w] < INT_MAX)
+            {
+                edgeDest.push_back(w);
+                edgeCost.push_back(costs[w]);
+            } // end if (w != v && costs[w] < INT_MAX)
+        } // end for (int w = 1)
+    } // end for (int v = 1)
+
+    edgeStart[size + 1] = edgeDest.size();
+    maxCost = edgeCost.empty() ? 0 : *max_element(edgeCost.begin(),
+                                                  edgeCost.end());
+    inStart.assign(size + 2, 0);
+    inSource.resize(edgeDest.size());
+    inCost.resize(edgeDest.size());
+
+    for (int e = 0; e < (int)edgeDest.size(); ++e)
+    {
+        ++inStart[edgeDest[e] + 1];         // count the in-edges of each node
+    } // end for (int e = 0)
+
+    for (int w = 1; w <= size + 1; ++w)
+    {
+        inStart[w] += inStart[w - 1];
+    } // end for (int w = 1)
+
+    vector<int> slot(inStart.begin(), inStart.end() - 1);  // next free slot
+
+    for (int v = 1; v <= size; ++v)
+    {
+        for (int e = edgeStart[v]; e < edgeStart[v + 1]; ++e)
+        {
+            inSource[slot[edgeDest[e]]] = v;
+            inCost[slot[edgeDest[e]]++] = edgeCost[e];
+        } // end for (int e = edgeStart[v])
+    } // end for (int v = 1)
+
+    edged = true;
+} // end buildEdges()
+
+/**---------------------- startQuery() ----------------------------------------
+ * Readies the scratch arrays of queryPath() for a new query. Entries are not
+ * cleared; each records the query that last set it, and older entries count
+ * as unset, so a query costs nothing for the nodes it never reaches.
+ * @pre None.
+ * @post No node is reached by either search of the new query.
+ */
+void GraphM::startQuery(void)
+{
+    if ((int)queryMark[0].size() != size + 1 || ++queryId == 0)
+    {
+        for (int side = 0; side < 2; ++side)
+        {
+            queryDist[side].assign(size + 1, INT_MAX);
+            queryPrev[side].assign(size + 1, 0);
+            queryMark[side].assign(size + 1, 0);
+        } // end for (int side = 0)
+
+        queryId = 1;
+    } // end if ((int)queryMark[0].size() != size + 1 || ...)
+} // end startQuery()
+
+/**---------------------- reached() -------------------------------------------
+ * Determines whether one search of the current query has reached a node.
+ * @param side  0 for the forward search; 1 for the backward search.
+ * @param v  The node in question.
+ * @pre startQuery() has been called since the graph was sized.
+ * @post None.
+ * @return true if the search has a distance for v; false, otherwise.
+ */
+bool GraphM::reached(int side, int v) const
+{
+    return queryMark[side][v] == queryId;
+} // end reached(int, int)
+
+/**---------------------- reach() ---------------------------------------------
+ * Offers a path to a node during one search of the current query. A path
+ * shorter than the one known, or the first one found, is kept and the node
+ * is queued.
+ * @param side  0 for the forward search; 1 for the backward search.
+ * @param v  The node the path reaches.
+ * @param length  The length of the path.
+ * @param prev  The node before v on the path, toward the start of the
+ *              search; 0 if v is where the search starts.
+ * @param heap  The nodes waiting in that search.
+ * @param shortened  Counts the paths kept, with GRAPH_STATS; the caller adds
+ *                   it to the shared counters once per query.
+ * @pre startQuery() has been called since the graph was sized.
+ * @post The search holds the better of the two paths to v.
+ * @return true if the path was kept; false, otherwise.
+ */
+bool GraphM::reach(int side, int v, int length, int prev, PathHeap& heap,
+                   uint64_t& shortened)
+{
+    if (reached(side, v) && queryDist[side][v] <= length)
+    {
+        return false;
+    } // end if (reached(side, v) && ...)
+
+    queryMark[side][v] = queryId;
+    queryDist[side][v] = length;
+    queryPrev[side][v] = prev;
+    heap.push(make_pair(length, v));
+    STATS_ADD(shortened, 1);
+    (void)shortened;            // counted only with GRAPH_STATS
+    return true;
+} // end reach(int, int, int, int, PathHeap&, uint64_t&)
+
+/**---------------------- joinPath() ------------------------------------------
+ * Lists the nodes on the path found by the current query, following the
+ * forward search back from the meeting node to the source and then the
+ * backward search, if it reached the meeting node, on to the destination.
+ * @param meet  The node at which the two searches joined.
+ * @param nodes  Receives the nodes, from source to dest.
+ * @pre The forward search has reached meet.
+ * @post None.
+ */
+void GraphM::joinPath(int meet, vector<int>& nodes) const
+{
+    nodes.clear();
+
+    for (int v = meet; v != 0; v = queryPrev[0][v])
+    {
+        nodes.push_back(v);
+    } // end for (int v = meet)
+
+    reverse(nodes.begin(), nodes.end());
+
+    if (reached(1, meet))
+    {
+        for (int v = queryPrev[1][meet]; v != 0; v = queryPrev[1][v])
+        {
+            nodes.push_back(v);
+        } // end for (int v = queryPrev[1][meet])
+    } // end if (reached(1, meet))
+} // end joinPath(int, vector<int>&)
+
+/**---------------------- fillTable() -----------------------------------------
+ * Fills a table of shortest paths between origins and targets, neither
+ * changing the path matrix nor needing it. Rows whose origin has a current
+ * row of the path matrix are copied from it. When only distances are
+ * wanted and the contraction hierarchy is built, the other origins and the
+ * targets share their search work through it: each climbs the hierarchy
+ * once, and the table is read off where the climbs meet. The hierarchy is
+ * not built here, since that costs far more than a table. Otherwise each
+ * other origin is searched once with Dijkstra's algorithm, however often it
+ * is listed, and its search stops as soon as every target is settled; these
+ * searches share no work, so each costs as much as a search for its origin
+ * alone. They are split into up to TABLETASKS tasks per worker, and each
+ * task reuses one set of scratch arrays for all of its origins. Paths match
+ * those display() prints.
+ * @param origins  The nodes from which paths start; one row each.
+ * @param targets  The nodes at which paths end; one column each.
+ * @param table  Receives the length of each path, row by row.
+ * @param previous  Receives the node before the target on each path; NULL
+ *                  if not wanted.
+ * @pre None.
+ * @post The out-edge and in-edge lists match the cost matrix.
+ */
+void GraphM::fillTable(const vector<int>& origins, const vector<int>& targets,
+                       vector<int>& table, vector<int>* previous)
+{
+    size_t      cols = targets.size();
+    vector<int> column(size + 1, -1);   // first column of each target node
+    vector<int> firstRow(size + 1, -1); // first row of each origin node
+    vector<int> searched;               // rows whose origin must be searched
+    int         wanted = 0;             // target nodes, each counted once
+    int         tasks;
+    STATS_TIME(counters.pathNs);
+
+    table.assign(origins.size() * cols, INT_MAX);
+
+    if (previous != NULL)
+    {
+        previous->assign(table.size(), 0);
+    } // end if (previous != NULL)
+
+    for (size_t j = 0; j < cols; ++j)
+    {
+        int w = inner(targets[j]);
+
+        if (w >= 1 && w <= size && column[w] < 0)
+        {
+            column[w] = j;
+            ++wanted;
+        } // end if (w >= 1 && ...)
+    } // end for (size_t j = 0)
+
+    if (wanted == 0)
+    {
+        return;
+    } // end if (wanted == 0)
+
+    for (size_t i = 0; i < origins.size(); ++i)
+    {
+        int v = inner(origins[i]);
+
+        if (v < 1 || v > size || firstRow[v] >= 0)
+        {
+            continue;
+        } // end if (v < 1 || ...)
+
+        firstRow[v] = i;
 
-/**---------------------- Default Constructor ---------------------------------
- * Creates an empty graph and initializes matrixes to sane values.
- * @pre None.
- * @post An empty graph exists and none of the matrix nodes contain garbage
- *       values.
- */
-GraphM::GraphM() : size(0), pathed(false)
-{
-    for (int i = 0; i < NODELIMIT; ++i)
-    {
-        for (int j = 0; j < NODELIMIT; ++j)
+        if (!pathed[v])
         {
-            C[i][j] = INT_MAX;          // empty adjacency matrix
-            T[i][j].visited = false;    // all nodes unvisited
-            T[i][j].dist = INT_MAX;     // min known distance is infinity
-            T[i][j].path = 0;           // no known paths
-        } // end for (int j = 0)
-    } // end for (int i = 0)
-} // end Constructor
+            searched.push_back(i);
+            continue;
+        } // end if (!pathed[v])
 
-/**---------------------- buildGraph() ----------------------------------------
- * Builds a graph from data in an ifstream. The input file must be formatted so
- * that the first line contains only the number of nodes. The next lines should
- * contain text descriptions of the nodes, one per line, for as many lines as
- * were specified by the integer on the first line. All remaining lines should
- * contain three integers separated by white space. These represent edges. The
- * first is the starting node, the second the destination node, and the third
- * is the cost of the edge. Input it terminated when an edge line begins with a
- * 0.
- * @param input  The stream from which to read a graph structure. Must be
- *               formatted as described above.
- * @pre The ifstream is readable and contains a valid graph description.
- * @post This graph will represent the data from input.
- */
-void GraphM::buildGraph(ifstream& input)
-{
-    int    nodeCount, source, dest, cost;   // containers for validation
-    string description;
+        STATS_ADD(counters.cacheHits, 1);
 
-    input >> nodeCount;         // expect positive int for size
+        for (int w = 1; w <= size; ++w)
+        {
+            if (column[w] >= 0)
+            {
+                table[i * cols + column[w]] = Tdist[cell(v, w)];
+
+                if (previous != NULL)
+                {
+                    (*previous)[i * cols + column[w]] =
+                        outer(Tpath[cell(v, w)]);
+                } // end if (previous != NULL)
+            } // end if (column[w] >= 0)
+        } // end for (int w = 1)
+    } // end for (size_t i = 0)
 
-    if (nodeCount > 0 && nodeCount < NODELIMIT)     // valid number of nodes
+    if (!searched.empty() && ranked && previous == NULL)
     {
-        input.get();            // clear end of line
-        size = nodeCount;       // number of nodes to expect from file
+        vector<int> sources, ends, lengths;     // inner numbers, and the
+                                                //  table between them
+        for (size_t k = 0; k < searched.size(); ++k)
+        {
+            sources.push_back(inner(origins[searched[k]]));
+        } // end for (size_t k = 0)
 
-        for (int i = 1; i <= size; ++i)
+        for (int w = 1; w <= size; ++w)
         {
-            getline(input, description);    // each line, one per node, should
-            data[i] = description;          //  contain description of node
-            C[i][i] = 0;                    // node distance to self is zero
-        } // end for (int i = 1)
+            if (column[w] >= 0)
+            {
+                ends.push_back(w);
+            } // end if (column[w] >= 0)
+        } // end for (int w = 1)
 
-        input >> source >> dest >> cost;    // get first edge
+        if (threads == 1)
+        {
+            shortcuts.table(sources, ends, lengths, NULL);
+        }
+        else
+        {
+            WorkPool pool(threads);
+            shortcuts.table(sources, ends, lengths, &pool);
+        } // end if (threads == 1)
 
-        while(source != 0)  // check for termination of input
+        for (size_t k = 0; k < searched.size(); ++k)
         {
-            input.get();    // clear end of line
-            
-            if (!insertEdge(source, dest, cost))    // insert failed
+            for (size_t c = 0; c < ends.size(); ++c)
             {
-                cerr << "ERROR: Could not insert edge (" << source << ", " <<
-                        dest << ") with cost of " << cost << endl;
-            } // end if (!insertEdge(source, dest, cost))
-
-            input >> source >> dest >> cost;        // get next edge
-        } // end while(source != 0)
-    } // end if (nodeCount >= 0)
-} // end buildGraph(ifstream&)
+                table[searched[k] * cols + column[ends[c]]] =
+                    lengths[k * ends.size() + c];
+            } // end for (size_t c = 0)
+        } // end for (size_t k = 0)
 
-/**---------------------- insertEdge() ----------------------------------------
- * Inserts a single edge into the graph between two existing nodes.
- * @param source  The node from which to start the edge.
- * @param dest  The adjacent node at which to end the edge.
- * @param cost  The cost of the edge between the nodes.
- * @pre source and dest are within the limits of the adjacency matrix; cost is
- *      positive.
- * @post The edge now exists in this graph. Any shortest paths found are no
- *       longer valid.
- * @return true if the input was valid and the edge could be added; false,
- *         otherwise.
- */
-bool GraphM::insertEdge(int source, int dest, int cost)
-{
-    bool success = (source > 0 && source <= size && cost > 0 &&     // validate
-                    dest > 0 && dest <= size && source != dest);    //  input
+        searched.clear();
+    } // end if (!searched.empty() && ...)
 
-    if (success)    // input is within matrix bounds
+    if (!searched.empty() && !edged)
     {
-        C[source][dest] = cost;         // update cell with cost
-        pathed = false;
-    } // end if (success)
-
-    return success;
-} // end insertEdge(int, int, int)
+        buildEdges();
+    } // end if (!searched.empty() && !edged)
 
-/**---------------------- removeEdge() ----------------------------------------
- * Removes a single existing edge from the graph.
- * @param source  The node from which the edge starts.
- * @param dest  The adjacent node at which the edge ends.
- * @pre The specified edge exists within this graph.
- * @post The edge is removed from this graph. Any shortest paths found are no
- *       longer valid.
- * @return true if the input was valid and the edge is now not in the graph;
- *         false, otherwise.
- */
-bool GraphM::removeEdge(int source, int dest)
-{
-    bool success = (source > 0 && source <= size &&         // validate input
-                    dest > 0 && dest <=size && source != dest);
+    tasks = min((int)searched.size(), threads * TABLETASKS);
 
-    if (success)    // input is within matrix bounds
+    function<void(int)> searchRows = [&](int task)
     {
-        C[source][dest] = INT_MAX;      // update cell to infinity
-        pathed = false;
-    } // end if (success)
+        TableSearch search;
 
-    return success;
-} // end removeEdge(int, int)
+        search.dist.assign(size + 1, INT_MAX);
+        search.prev.assign(size + 1, 0);
 
-/**---------------------- findShortestPath() ----------------------------------
- * Uses Dijkstra's Algorithm to find the shortes paths from every node to every
- * other node. A path matrix is used to store path descriptions.
- * @pre The graph is not empty.
- * @post All shortest paths are represented in the path matrix. A flag is set
- *       to indicate the matrix is valid.
- */
-void GraphM::findShortestPath(void)
-{
-    int numVisits, v;
+        for (size_t k = task; k < searched.size(); k += tasks)
+        {
+            size_t row = searched[k] * cols;
 
-    if (!pathed)
+            tableRow(inner(origins[searched[k]]), column, wanted, search,
+                     &table[row], previous ? &(*previous)[row] : NULL);
+        } // end for (size_t k = task)
+    };
+
+    if (threads == 1 || tasks <= 1)
     {
-        for (int i = 1; i <= size; ++i)
+        for (int task = 0; task < tasks; ++task)
         {
-            for (int j = 1; j <= size; ++j)
-            {
-                T[i][j].dist = INT_MAX;
-                T[i][j].path = 0;
-                T[i][j].visited = false;
-            } // end for (int j = 1)
-        } // end for (int i = 1)
+            searchRows(task);
+        } // end for (int task = 0)
+    }
+    else
+    {
+        WorkPool pool(threads);
+        pool.run(0, tasks - 1, searchRows);
+    } // end if (threads == 1 || tasks <= 1)
 
-        for (int source = 1; source <= size; ++source)
+    for (size_t i = 0; i < origins.size(); ++i)     // copy repeated origins
+    {                                               //  and targets
+        int v = inner(origins[i]);
+
+        for (size_t j = 0; v >= 1 && v <= size && j < cols; ++j)
         {
-            numVisits = 0;
-            T[source][source].dist = 0;
+            int    w = inner(targets[j]);
+            size_t from;
 
-            while(numVisits < size)
+            if (w < 1 || w > size)
             {
-                v = findV(source);
-                T[source][v].visited = true;
-                ++numVisits;
-                setW(source, v);
-            } // end while(numVisits < size)
-        } // end for (int source = 1)
-    } // end if (!pathed)
+                continue;
+            } // end if (w < 1 || ...)
 
-    pathed = true;
-} // end findShortestPath()
+            from = firstRow[v] * cols + column[w];
+
+            if (from != i * cols + j)
+            {
+                table[i * cols + j] = table[from];
+
+                if (previous != NULL)
+                {
+                    (*previous)[i * cols + j] = (*previous)[from];
+                } // end if (previous != NULL)
+            } // end if (from != i * cols + j)
+        } // end for (size_t j = 0)
+    } // end for (size_t i = 0)
+} // end fillTable(const vector<int>&, const vector<int>&, ...)
+
+/**---------------------- tableRow() ------------------------------------------
+ * Fills one row of a table with dijkstra() from its origin, as heapPath()
+ * does, and stops once every target is settled. Only the scratch entries
+ * the search reached are reset afterwards, so an origin costs nothing for
+ * the nodes it never reaches.
+ * @param origin  The node from which to find paths.
+ * @param column  The column of each target node; -1 for other nodes.
+ * @param wanted  The number of target nodes.
+ * @param search  The scratch arrays, sized to this graph and reset.
+ * @param distances  Receives the length of the path to each target, in its
+ *                   column.
+ * @param previous  Receives the node before each target on its path; NULL
+ *                  if not wanted.
+ * @pre The out-edge lists match the cost matrix.
+ * @post The row holds the paths from origin to every target it reaches.
+ *       The scratch arrays are reset.
+ */
+void GraphM::tableRow(int origin, const vector<int>& column, int wanted,
+                      TableSearch& search, int* distances, int* previous)
+{
+    uint64_t settled = 0, shortened = 0;        // counts, with GRAPH_STATS
+
+    dijkstra(origin, edgeStart.data(), edgeDest.data(), edgeCost.data(),
+             search.dist.data(), search.prev.data(), &search.touched,
+             [&](int v)
+             {
+                 if (column[v] >= 0)
+                 {
+                     distances[column[v]] = search.dist[v];
+                     --wanted;
+
+                     if (previous != NULL)
+                     {
+                         previous[column[v]] = outer(search.prev[v]);
+                     } // end if (previous != NULL)
+                 } // end if (column[v] >= 0)
+
+                 return wanted > 0;
+             }, settled, shortened);
+
+    for (size_t i = 0; i < search.touched.size(); ++i)
+    {
+        search.dist[search.touched[i]] = INT_MAX;
+        search.prev[search.touched[i]] = 0;
+    } // end for (size_t i = 0)
+
+    search.touched.clear();
+    STATS_ADD(counters.settled, settled);
+    STATS_ADD(counters.relaxations, shortened);
+} // end tableRow(int, const vector<int>&, int, TableSearch&, int*, int*)
 
 /**---------------------- findV() ---------------------------------------------
- * Finds a vector to visit for the shortest path routine.
+ * Finds a vector to visit for the shortest path routine: the unvisited node
+ * with the least distance, the lowest numbered one on a tie. With AVX2 the
+ * distances are masked by the visited bitset and scanned eight at a time.
  * @param source  The node from which to search for an adjacent node to visit.
+ * @param visited  One bit per node, set for nodes already visited.
  * @pre This graph is not empty.
  * @post None.
- * @return The index of the node that should be visited next.
+ * @return The index of the node that should be visited next, or 0 if every
+ *         unvisited node is unreachable.
  */
-int GraphM::findV(int source)
+int GraphM::findV(int source, const uint64_t* visited) const
 {
+    const int* dist = &Tdist[cell(source, 0)];  // path matrix row for source
     int v = 0;
 
+#ifdef GRAPHM_AVX2
+    if (cpuHasAvx2())
+    {
+        return findVAvx2(dist, visited, stride);
+    } // end if (cpuHasAvx2())
+#endif
+
     for (int i = 1; i <= size; ++i)
     {
-        if (!T[source][i].visited)
+        if (!(visited[i / 64] >> (i % 64) & 1))
         {
-            if (T[source][i].dist < T[source][v].dist)
+            if (dist[i] < dist[v])
             {
                 v = i;
-            } // end if (T[source][i].dist < T[source][v].dist)
-        } // end if (!T[source][i].visited...)
+            } // end if (dist[i] < dist[v])
+        } // end if (!(visited[i / 64] >> (i % 64) & 1))
     } // end for (int i = 1)
 
     return v;
-} // end findV(int, int&)
+} // end findV(int, const uint64_t*)
 
 /**---------------------- setW() --- ------------------------------------------
  * Sets the current shortest path information on all nodes adjacent to the
- * visited node.
+ * visited node. Visited nodes need no test: with positive costs their
+ * distance can never be improved. With AVX2 eight nodes are relaxed at once.
  * @param source  The node from which a path is being determined.
+ * @param v  The node being visited.
+ * @param shortened  Counts the paths shortened, with GRAPH_STATS; the
+ *                   caller adds it to the shared counters once per row.
  * @pre v has been found and is the correct node to visit.
  * @post The path matrix is updated with the shortest distance currently known
  *       for all nodes adjacent to v.
  */
-void GraphM::setW(int source, int v)
+void GraphM::setW(int source, int v, uint64_t& shortened)
 {
+    int*       dist = &Tdist[cell(source, 0)];  // path matrix row for source
+    int*       path = &Tpath[cell(source, 0)];
+    const int* costs = &C[cell(v, 0)];          // cost matrix row for v
+
+    if (dist[v] == INT_MAX)     // nothing is reachable through v
+    {
+        return;
+    } // end if (dist[v] == INT_MAX)
+
+#ifdef GRAPHM_AVX2
+    if (cpuHasAvx2())
+    {
+        int found = setWAvx2(dist, path, costs, v, stride);
+
+        STATS_ADD(shortened, found);
+        (void)found;            // counted only with GRAPH_STATS
+        return;
+    } // end if (cpuHasAvx2())
+#endif
+
     for (int w = 1; w <= size; ++w)
     {
-        if (!T[source][w].visited && C[v][w] < INT_MAX &&
-             T[source][v].dist < INT_MAX)
+        if (costs[w] < INT_MAX && dist[w] > (dist[v] + costs[w]))
         {
-            if (T[source][w].dist > (T[source][v].dist + C[v][w]))
-            {
-                T[source][w].dist = T[source][v].dist + C[v][w];
-                T[source][w].path = v;
-            } // end if (T[source][w].dist > (T[source][v].dist + C[v][w]))
-        } // end if (!T[source][w].visited...)
+            dist[w] = dist[v] + costs[w];
+            path[w] = v;
+            STATS_ADD(shortened, 1);
+        } // end if (costs[w] < INT_MAX && ...)
     } // end for (int w = 1)
-} // end setW(int, int, int)
+
+    (void)shortened;            // counted only with GRAPH_STATS
+} // end setW(int, int, uint64_t&)
+
+/**---------------------- cell() --------------------------------------------
+ * Finds the position of a cell in one of the matrixes, which are stored one
+ * padded row after another.
+ * @param row  The row of the cell; usually the node a path or edge leaves.
+ * @param col  The column of the cell; usually the node a path or edge enters.
+ * @pre None.
+ * @post None.
+ * @return The index of the cell in C or T.
+ */
+size_t GraphM::cell(int row, int col) const
+{
+    return static_cast<size_t>(row) * stride + col;
+} // end cell(int, int)
 
 /**---------------------- displayAll() ----------------------------------------
  * Prints out a list of all nodes and their adjacencies. Requires that shortest
@@ -235,136 +2312,456 @@ void GraphM::setW(int source, int v)
  */
 void GraphM::displayAll(void)
 {
-    if (!pathed)
-    {
-        findShortestPath();
-    } // end if (!pathed)
+    displayAll(cout);
+} // end displayAll()
 
-    cout.width(26);
-    cout << left << "Description";
-    cout.width(11);
-    cout << "From node";
-    cout.width(9);
-    cout << "To node";
-    cout.width(12);
-    cout << "Dijkstra's";
-    cout.width();
-    cout << "Path" << endl;
+/**---------------------- displayAll() ----------------------------------------
+ * Prints out a list of all nodes and their adjacencies to a stream, as
+ * displayAll() does to cout. The report is gathered in a buffer and written
+ * in large chunks.
+ * @param output  The stream to which to print.
+ * @pre The graph is not empty.
+ * @post If paths were not valid, they have been updated.
+ */
+void GraphM::displayAll(ostream& output)
+{
+    ReportWriter report(output);
+    vector<int>  nodes;                 // reused for every path
+    STATS_TIME(counters.displayNs);
+
+    findShortestPath();
+
+    report.writeLeft("Description", 26);
+    report.writeLeft("From node", 11);
+    report.writeLeft("To node", 9);
+    report.writeLeft("Dijkstra's", 12);
+    report.write("Path\n");
 
     for (int source = 1; source <= size; ++source)
     {
-        displayFrom(source);
+        displayFrom(source, report, nodes);
     } // end for (int i = 1)
 
-    cout << endl;
-} // end displayAll()
+    report.write('\n');
+} // end displayAll(ostream&)
+
+/**---------------------- writeCsv() ------------------------------------------
+ * Writes every shortest path in a compact form for other programs to read:
+ * a header line, then one line per ordered pair of distinct nodes holding
+ * the source, destination, distance and the nodes of the path separated by
+ * spaces. The last two fields are empty if there is no path. Nodes are given
+ * by their input numbers.
+ * @param output  The stream to which to write.
+ * @pre None.
+ * @post If paths were not valid, they have been updated.
+ */
+void GraphM::writeCsv(ostream& output)
+{
+    ReportWriter report(output);
+    vector<int>  nodes;                 // reused for every path
+
+    findShortestPath();
+    report.write("source,dest,distance,path\n");
+
+    for (int source = 1; source <= size; ++source)
+    {
+        int from = inner(source);
+
+        for (int dest = 1; dest <= size; ++dest)
+        {
+            if (dest != source)
+            {
+                int to = inner(dest);
+
+                report.writeInt(source);
+                report.write(',');
+                report.writeInt(dest);
+                report.write(',');
+
+                if (Tdist[cell(from, to)] != INT_MAX)
+                {
+                    report.writeInt(Tdist[cell(from, to)]);
+                    report.write(',');
+                    displayPath(from, to, report, nodes);
+                }
+                else
+                {
+                    report.write(',');
+                } // end if (Tdist[cell(from, to)] != INT_MAX)
+
+                report.write('\n');
+            } // end if (dest != source)
+        } // end for (int dest = 1)
+    } // end for (int source = 1)
+} // end writeCsv(ostream&)
 
 /**---------------------- displayFrom() ---------------------------------------
  * Displays all the nodes that have paths from a specified node. Requires that
- * shortest paths have been found.
+ * shortest paths have been found. Nodes are given by their input numbers.
  * @param sourse  The node from which to display paths.
+ * @param report  The report to which to print.
+ * @param nodes  Scratch space for the nodes on a path.
  * @pre The graph is not empty. The path matrix is valid.
  * @post None.
  */
-void GraphM::displayFrom(int source)
+void GraphM::displayFrom(int source, ReportWriter& report, vector<int>& nodes)
 {
-    cout.width(32);
-    cout << left << data[source] << endl;
+    int from = inner(source), to;
+
+    report.writeLeft(names.text(source), names.length(source), 32);
+    report.write('\n');
 
     for (int dest = 1; dest <= size; ++dest)
     {
         if (dest != source)
         {
-            cout.width(35);
-            cout << right << source;
-            cout.width(5);
-            cout << dest;
-            cout.width(14);
+            to = inner(dest);
+            report.writeInt(source, 35);
+            report.writeInt(dest, 5);
 
-            if (T[source][dest].dist == INT_MAX)
+            if (Tdist[cell(from, to)] == INT_MAX)
             {
-                cout << "----" << endl;
+                report.writeRight("----", 14);
             }
             else
             {
-                cout << T[source][dest].dist;
-                cout.width();
-                cout << "    ";
-                displayPath(source, dest);
-                cout << dest << endl;
-            } // end if (T[source][dest].dist == INT_MAX)
+                report.writeInt(Tdist[cell(from, to)], 14);
+                report.write("    ");
+                displayPath(from, to, report, nodes);
+            } // end if (Tdist[cell(from, to)] == INT_MAX)
+
+            report.write('\n');
         } // end if (dest != source)
     } // end for (int dest = 1)
-} // end displayFrom(int)
+} // end displayFrom(int, ReportWriter&, vector<int>&)
 
-/**---------------------- displayPath() ---------------------------------------
- * Displays the full path and distance between two nodes. Requires that
- * shortest paths have been found.
+/**---------------------- extractPath() ---------------------------------------
+ * Lists the nodes on the shortest path between two nodes into a caller's
+ * list, finding the paths from source first if they are not current. The
+ * path is walked back from dest without recursion, or copied from the path
+ * cache if it is kept there. A list reused from call to call allocates only
+ * when a path is longer than any before.
  * @param source  The node from which to start the path.
  * @param dest  The node at which to end the path.
- * @pre This graph is not empty.
- * @post None.
+ * @param nodes  Receives the nodes on the path, from source to dest; empty
+ *               if there is none.
+ * @pre None.
+ * @post The row of the path matrix for source is current if source is in
+ *       this graph.
+ * @return The length of the path, or INT_MAX if there is none or either node
+ *         is not in this graph.
  */
-void GraphM::displayPath(int source, int dest)
+int GraphM::extractPath(int source, int dest, vector<int>& nodes)
 {
-    if (!pathed)
+    const vector<int>* kept;
+
+    nodes.clear();
+
+    if (source < 1 || source > size || dest < 1 || dest > size)
+    {
+        return INT_MAX;
+    } // end if (source < 1 || ...)
+
+    findShortestPath(source);
+    source = inner(source);
+    dest = inner(dest);
+
+    if (Tdist[cell(source, dest)] == INT_MAX)
     {
-        findShortestPath();
-    } // end if (!pathed)
+        return INT_MAX;
+    } // end if (Tdist[cell(source, dest)] == INT_MAX)
 
-    if (T[source][dest].path != 0)
+    kept = cachedPath(source, dest);
+
+    if (kept != NULL)
+    {
+        nodes.assign(kept->begin(), kept->end());
+    }
+    else
     {
-        displayPath(source, T[source][dest].path);
-        cout << T[source][dest].path << ' ';
-    } // end if (T[source][dest].path != 0)
-} // end displayPath(int, int)
+        findPath(source, dest, nodes);
+    } // end if (kept != NULL)
 
-/**---------------------- display() 0------------------------------------------
- * Displays the full path and distance between two specified nodes. Requires
- * that shortest paths have been found.
+    outerPath(nodes);
+    return Tdist[cell(source, dest)];
+} // end extractPath(int, int, vector<int>&)
+
+/**---------------------- extractPath() ---------------------------------------
+ * Writes the nodes on the shortest path between two nodes into a caller's
+ * array, as extractPath() does into a list, with no allocation at all when
+ * the path cache is off. The path is counted on a first walk back from dest
+ * and written back to front on a second.
  * @param source  The node from which to start the path.
  * @param dest  The node at which to end the path.
- * @pre This graph is not empty.
- * @post If paths were not valid, they have been updated.
+ * @param nodes  Receives the nodes on the path, from source to dest.
+ * @param count  On entry, the room in nodes; on return, the number of nodes
+ *               on the path, or 0 if there is none. If the path needs more
+ *               room than there is, nothing is written and the call may be
+ *               repeated with a larger array.
+ * @pre nodes has room for count nodes.
+ * @post The row of the path matrix for source is current if source is in
+ *       this graph.
+ * @return The length of the path, or INT_MAX if there is none or either node
+ *         is not in this graph.
  */
-void GraphM::display(int source, int dest)
+int GraphM::extractPath(int source, int dest, int* nodes, int& count)
 {
-    if (!pathed)
+    const vector<int>* kept;
+    int room = count;
+
+    count = 0;
+
+    if (source < 1 || source > size || dest < 1 || dest > size)
+    {
+        return INT_MAX;
+    } // end if (source < 1 || ...)
+
+    findShortestPath(source);
+    source = inner(source);
+    dest = inner(dest);
+
+    if (Tdist[cell(source, dest)] == INT_MAX)
+    {
+        return INT_MAX;
+    } // end if (Tdist[cell(source, dest)] == INT_MAX)
+
+    kept = cachedPath(source, dest);
+
+    if (kept != NULL)
     {
-        if (T[source][dest].dist < INT_MAX)
+        count = (int)kept->size();
+
+        for (int i = 0; count <= room && i < count; ++i)
         {
-            cout.width(4);
-            cout << right << source;
-            cout.width(8);
-            cout << dest;
-            cout.width(8);
-            cout << T[source][dest].dist;
-            cout << "        ";
-            displayPath(source, dest);
-            cout << source << endl << data[dest] << endl;
-            pathDesc(source, dest);
-        }
-        else
+            nodes[i] = outer((*kept)[i]);
+        } // end for (int i = 0)
+    }
+    else
+    {
+        for (int v = dest; v != 0; v = Tpath[cell(source, v)])
         {
-            cout << "No path from " << source << " to " << dest << '.' << endl;
-        } // end if (T[source][dest].dist < INT_MAX)
-    } // end if (!pathed)
+            ++count;
+        } // end for (int v = dest)
 
-    cout << endl;
-} // end display(int, int)
+        if (count <= room)
+        {
+            int i = count;
+
+            for (int v = dest; v != 0; v = Tpath[cell(source, v)])
+            {
+                nodes[--i] = outer(v);
+            } // end for (int v = dest)
+        } // end if (count <= room)
+    } // end if (kept != NULL)
+
+    return Tdist[cell(source, dest)];
+} // end extractPath(int, int, int*, int&)
+
+/**---------------------- readPath() ------------------------------------------
+ * Lists the nodes on the shortest path between two nodes from the path
+ * matrix as it stands, neither finding paths nor using the path cache. As
+ * nothing in the graph changes, any number of threads may read paths from
+ * a graph that no thread is changing.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @param nodes  Receives the nodes on the path, from source to dest; empty
+ *               if there is none or it is not known.
+ * @pre None.
+ * @post None.
+ * @return The length of the path, or INT_MAX if there is none, either node
+ *         is not in this graph or the row of the path matrix for source is
+ *         not current.
+ */
+int GraphM::readPath(int source, int dest, vector<int>& nodes) const
+{
+    nodes.clear();
+    source = inner(source);
+    dest = inner(dest);
 
-/**---------------------- pathDesc() ------------------------------------------
- * Displays the description of a path.
- * @param source  The node from which to display a path description.
+    if (source < 1 || source > size || dest < 1 || dest > size ||
+        !pathed[source] || Tdist[cell(source, dest)] == INT_MAX)
+    {
+        return INT_MAX;
+    } // end if (source < 1 || ...)
+
+    findPath(source, dest, nodes);
+    outerPath(nodes);
+    return Tdist[cell(source, dest)];
+} // end readPath(int, int, vector<int>&)
+
+/**---------------------- readDistance() --------------------------------------
+ * Finds the length of the shortest path between two nodes from the path
+ * matrix as it stands, as readPath() does, without listing its nodes.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @pre None.
+ * @post None.
+ * @return The length of the path, or INT_MAX if there is none, either node
+ *         is not in this graph or the row of the path matrix for source is
+ *         not current.
+ */
+int GraphM::readDistance(int source, int dest) const
+{
+    source = inner(source);
+    dest = inner(dest);
+
+    if (source < 1 || source > size || dest < 1 || dest > size ||
+        !pathed[source])
+    {
+        return INT_MAX;
+    } // end if (source < 1 || ...)
+
+    return Tdist[cell(source, dest)];
+} // end readDistance(int, int)
+
+/**---------------------- cachedPath() ----------------------------------------
+ * Fetches a path from the path cache, walking it into the cache first if it
+ * is not kept there.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @pre The row of the path matrix for source is current, and dest can be
+ *      reached from source.
+ * @post If the cache is on, the path is its most recently used entry.
+ * @return The nodes on the path, valid until the cache next changes; NULL if
+ *         the cache is off.
+ */
+const vector<int>* GraphM::cachedPath(int source, int dest)
+{
+    const vector<int>* kept;
+
+    if (hotPaths.capacity() == 0)
+    {
+        return NULL;
+    } // end if (hotPaths.capacity() == 0)
+
+    kept = hotPaths.find(source, dest);
+
+    if (kept == NULL)
+    {
+        vector<int>& slot = hotPaths.insert(source, dest);
+
+        findPath(source, dest, slot);
+        kept = &slot;
+    } // end if (kept == NULL)
+
+    return kept;
+} // end cachedPath(int, int)
+
+/**---------------------- displayPath() ---------------------------------------
+ * Displays the nodes on the shortest path between two nodes, separated by
+ * spaces and by their input numbers.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @param report  The report to which to print.
+ * @param nodes  Scratch space for the nodes on the path.
+ * @pre The row of the path matrix for source is current, and dest can be
+ *      reached from source.
+ * @post None.
+ */
+void GraphM::displayPath(int source, int dest, ReportWriter& report,
+                         vector<int>& nodes) const
+{
+    findPath(source, dest, nodes);
+    outerPath(nodes);
+    writeNodes(nodes, report);
+} // end displayPath(int, int, ReportWriter&, vector<int>&)
+
+/**---------------------- writeNodes() ----------------------------------------
+ * Prints the nodes on a path, separated by spaces.
+ * @param nodes  The nodes on the path, in order.
+ * @param report  The report to which to print.
+ * @pre None.
+ * @post None.
+ */
+void GraphM::writeNodes(const vector<int>& nodes, ReportWriter& report) const
+{
+    for (int i = 0; i < (int)nodes.size(); ++i)
+    {
+        if (i > 0)
+        {
+            report.write(' ');
+        } // end if (i > 0)
+
+        report.writeInt(nodes[i]);
+    } // end for (int i = 0)
+} // end writeNodes(const vector<int>&, ReportWriter&)
+
+/**---------------------- findPath() ------------------------------------------
+ * Lists the nodes on the shortest path between two nodes by following the
+ * previous node of each back from dest.
+ * @param source  The node from which to start the path.
  * @param dest  The node at which to end the path.
- * @pre Shortest paths have been found.
+ * @param nodes  Receives the nodes, from source to dest.
+ * @pre The row of the path matrix for source is current, and dest can be
+ *      reached from source.
  * @post None.
  */
-void GraphM::pathDesc(int source, int dest)
+void GraphM::findPath(int source, int dest, vector<int>& nodes) const
+{
+    nodes.clear();
+
+    for (int v = dest; v != 0; v = Tpath[cell(source, v)])
+    {
+        nodes.push_back(v);
+    } // end for (int v = dest)
+
+    reverse(nodes.begin(), nodes.end());
+} // end findPath(int, int, vector<int>&)
+
+/**---------------------- display() -------------------------------------------
+ * Displays the full path and distance between two specified nodes. Only the
+ * shortest paths from source are found, and only if they are not current.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @pre This graph is not empty.
+ * @post The row of the path matrix for source is current.
+ */
+void GraphM::display(int source, int dest)
+{
+    display(source, dest, cout);
+} // end display(int, int)
+
+/**---------------------- display() -------------------------------------------
+ * Displays the full path and distance between two specified nodes to a
+ * stream, as display() does to cout, followed by the description of each
+ * node on the path. Only the shortest paths from source are found, and only
+ * if they are not current. The path is fetched with extractPath(), so it
+ * comes from the path cache when it is kept there.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @param output  The stream to which to print.
+ * @pre This graph is not empty.
+ * @post The row of the path matrix for source is current.
+ */
+void GraphM::display(int source, int dest, ostream& output)
 {
-    if (T[source][dest].path != 0)
+    ReportWriter report(output);
+    STATS_TIME(counters.displayNs);
+    int distance = extractPath(source, dest, shown);
+
+    if (distance < INT_MAX)
     {
-        pathDesc(source, T[source][dest].path);
-        cout << data[dest] << endl;
-    } // end if (T[source][dest].path != 0)
-}
+        report.writeInt(source, 4);
+        report.writeInt(dest, 8);
+        report.writeInt(distance, 8);
+        report.write("        ");
+        writeNodes(shown, report);
+        report.write('\n');
+
+        for (int i = 0; i < (int)shown.size(); ++i)
+        {
+            report.write(names.text(shown[i]), names.length(shown[i]));
+            report.write('\n');
+        } // end for (int i = 0)
+    }
+    else
+    {
+        report.write("No path from ");
+        report.writeInt(source);
+        report.write(" to ");
+        report.writeInt(dest);
+        report.write(".\n");
+    } // end if (distance < INT_MAX)
+
+    report.write('\n');
+} // end display(int, int, ostream&)
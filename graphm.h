@@ -12,12 +12,48 @@
 #ifndef _GRAPHM_H
 #define	_GRAPHM_H
 
+#include <climits>
 #include <cstdlib>
+#include <functional>
+#include <queue>
+#include <stdint.h>
+#include <vector>
+#include "aligned.h"
+#include "dijkstra.h"
+#include "graphfile.h"
+#include "hierarchy.h"
+#include "nametable.h"
+#include "nodeorder.h"
 #include "nodedata.h"
+#include "pathcache.h"
+#include "pathfile.h"
+#include "pathstats.h"
+#include "report.h"
 
 using namespace std;
-const int NODELIMIT = 101;
 
+enum PathEngine
+{
+    MATRIX_SCAN,        // linear scans over rows of the cost and path matrixes
+    BINARY_HEAP,        // binary heap over out-edge lists built from C
+    BUCKET_QUEUE,       // Dial's buckets over the same lists, for small costs
+    FLOYD_WARSHALL,     // tiled Floyd-Warshall over the whole cost matrix
+    AUTO_ENGINE         // chosen from the size and density of the graph
+}; // end enum PathEngine
+
+const int ROWINTS      = ALIGNMENT / sizeof(int);  // matrix rows are padded
+                                                 //  to multiples of this
+const int SCANPERCENT  = 75;    // AUTO_ENGINE scans rows for one source once
+                                //  edges fill this much of the matrix
+const int FLOYDMIN     = 64;    // AUTO_ENGINE uses Floyd-Warshall from this
+const int FLOYDPERCENT = 3;     //  many nodes and once edges fill this much
+                                //  of the matrix
+const int BUCKETMAX    = 256;   // buckets replace the heap when no edge
+                                //  costs more than this
+const int TABLETASKS   = 4;     // distanceTable() splits its searches into
+                                //  this many tasks per worker
+const int REPAIRROWS   = 16;    // edge changes repair fewer rows than this
+                                //  on the calling thread
 
 class GraphM
 {
@@ -26,41 +62,193 @@ public:
     GraphM();
     
     void buildGraph(ifstream& input);
+
+    void buildGraph(GraphFile& input);
     
+    bool saveSnapshot(const char* name, bool withPaths) const;
+
+    bool loadSnapshot(const char* name);
+
+    bool savePaths(const char* name, bool narrow);
+
+    void reorder(NodeOrder order);
+
     bool insertEdge(int source, int dest, int cost);
     
     bool removeEdge(int source, int dest);
     
     void findShortestPath(void);
+
+    void findShortestPath(int source);
+
+    int queryPath(int source, int dest, vector<int>& nodes);
+
+    int queryPath(int source, int dest, vector<int>& nodes,
+                  const function<int(int)>& estimate);
+
+    void buildHierarchy(void);
+
+    int routePath(int source, int dest, vector<int>& nodes);
+
+    const ContractionHierarchy& hierarchy(void) const;
+
+    void distanceTable(const vector<int>& origins, const vector<int>& targets,
+                       vector<int>& table);
+
+    void distanceTable(const vector<int>& origins, const vector<int>& targets,
+                       vector<int>& table, vector<int>& previous);
+
+    int extractPath(int source, int dest, vector<int>& nodes);
+
+    int extractPath(int source, int dest, int* nodes, int& count);
+
+    int readPath(int source, int dest, vector<int>& nodes) const;
+
+    int readDistance(int source, int dest) const;
     
     void displayAll(void);
+
+    void displayAll(ostream& output);
     
     void display(int source, int dest);
 
+    void display(int source, int dest, ostream& output);
+
+    void writeCsv(ostream& output);
+
+    void setEngine(PathEngine newEngine);
+
+    void setThreads(int count);
+
+    void setRepair(bool enabled);
+
+    void setPathCache(int entries);
+
+    int findNode(const string& description) const;
+
+    const PathStats& stats(void) const;
+
+    void resetStats(void);
+
 private:
 
-    struct TableType
+    typedef vector<int, AlignedAllocator<int> > Matrix;   // rows of ints
+
+    NameTable        names;                 // interned node descriptions,
+                                            //  by input number
+    Matrix               C;                 // Cost array, the adjacency matrix
+    int               size;                 // number of nodes in the graph
+    int             stride;                 // length of a padded matrix row
+    Matrix           Tdist;                 // path matrix: shortest distance
+    Matrix           Tpath;                 //  and previous node in the path
+    vector<char> pathed;                    // which rows of T are current
+    PathEngine  engine;                     // algorithm used for paths
+    int    edges;                           // number of edges in C
+    vector<int> edgeStart;                  // first out-edge of each node
+    vector<int> edgeDest;                   // destination of each out-edge
+    vector<int> edgeCost;                   // cost of each out-edge
+    vector<int> inStart;                    // first in-edge of each node
+    vector<int> inSource;                   // source of each in-edge
+    vector<int> inCost;                     // cost of each in-edge
+    bool   edged;                           // out-edge lists match C
+    int    maxCost;                         // no edge in C costs more
+    int    threads;                         // workers for findShortestPath
+    bool   repair;                          // edge changes repair T in place
+    PathStats counters;                     // hot path statistics
+    vector<int>      queryDist[2];          // scratch for queryPath(): the
+    vector<int>      queryPrev[2];          //  forward and backward searches
+    vector<uint32_t> queryMark[2];          // query that last set each entry
+    uint32_t         queryId;               // number of the current query
+    ContractionHierarchy shortcuts;         // index for routePath()
+    bool   ranked;                          // shortcuts match C
+    PathCache   hotPaths;                   // recently extracted paths
+    vector<int> shown;                      // nodes of the path display()
+                                            //  prints, reused between calls
+    vector<int> innerOf;                    // node number of each input
+    vector<int> outerOf;                    //  number, and back; both empty
+                                            //  while the numbers match
+
+    typedef priority_queue<pair<int, int>, vector<pair<int, int> >,
+                           greater<pair<int, int> > > PathHeap;
+
+    struct TableSearch
     {
-        bool visited;       // whether node has been visited
-        int  dist;          // shortest distance from source known so far
-        int  path;          // previous node in path of min dist
-    }; // end struct TableType
+        vector<int> dist;           // distance to each node reached
+        vector<int> prev;           // node each was reached from
+        vector<int> touched;        // nodes reached, to reset afterwards
+    }; // end struct TableSearch
+
+    template <class Input>
+    void readGraph(Input& input);
+
+    void sizeGraph(int nodes);
+
+    int inner(int id) const;
+
+    int outer(int v) const;
+
+    void outerPath(vector<int>& nodes) const;
+
+    bool loadEdge(int source, int dest, int cost);
+
+    void findPathsFrom(int source);
+
+    PathEngine rowEngine(void) const;
+
+    bool useFloyd(int stale) const;
+
+    void floydAll(void);
+
+    void scanPath(int source);
+
+    void heapPath(int source);
+
+    void bucketPath(int source);
+
+    void buildEdges(void);
+
+    void fillTable(const vector<int>& origins, const vector<int>& targets,
+                   vector<int>& table, vector<int>* previous);
+
+    void tableRow(int origin, const vector<int>& column, int wanted,
+                  TableSearch& search, int* distances, int* previous);
+
+    void startQuery(void);
+
+    bool reached(int side, int v) const;
+
+    bool reach(int side, int v, int length, int prev, PathHeap& heap,
+               uint64_t& shortened);
+
+    void joinPath(int meet, vector<int>& nodes) const;
+
+    void repairPaths(int source, int dest, int oldCost);
+
+    void lowerCost(int source, int u, int v);
+
+    void raiseCost(int source, int u, int v);
+
+    void relax(int* dist, int* path, int v, int w, int length,
+               PathHeap& heap, uint64_t& shortened);
+
+    bool precedes(const int* dist, int v, int w) const;
+
+    size_t cell(int row, int col) const;
+
+    int findV(int source, const uint64_t* visited) const;
 
-    NodeData data[NODELIMIT];               // data for graph nodes information
-    int         C[NODELIMIT][NODELIMIT];    // Cost array, the adjacency matrix
-    int      size;                          // number of nodes in the graph
-    TableType   T[NODELIMIT][NODELIMIT];    // stores visited, distance, path
-    bool   pathed;                          // current shortest paths valid
+    void setW(int source, int v, uint64_t& shortened);
 
-    int findV(int source);
+    void displayFrom(int source, ReportWriter& report, vector<int>& nodes);
 
-    void setW(int source, int v);
+    void displayPath(int source, int dest, ReportWriter& report,
+                     vector<int>& nodes) const;
 
-    void displayFrom(int source);
+    void writeNodes(const vector<int>& nodes, ReportWriter& report) const;
 
-    void displayPath(int source, int dest);
+    void findPath(int source, int dest, vector<int>& nodes) const;
 
-    void pathDesc(int source, int dest);
+    const vector<int>* cachedPath(int source, int dest);
 
 }; // end class GraphM
 
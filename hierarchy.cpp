@@ -0,0 +1,812 @@
+/*
+ * @file    hierarchy.cpp
+ * @brief   This class answers shortest path queries between pairs of nodes
+ *          with a contraction hierarchy. Preprocessing removes the nodes one
+ *          at a time, least important first, adding shortcut edges that keep
+ *          the distances among the remaining nodes. A query runs two small
+ *          searches that only climb in rank and meets in the middle, then
+ *          unpacks the shortcuts on its path into the original nodes.
+ */
+
+#include <algorithm>
+#include "hierarchy.h"
+
+using namespace std;
+
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an empty hierarchy.
+ * @pre None.
+ * @post A hierarchy of no nodes exists.
+ */
+ContractionHierarchy::ContractionHierarchy() : size(0), added(0), seekId(0)
+{
+} // end constructor
+
+/**---------------------- build() ---------------------------------------------
+ * Builds the hierarchy for a graph given as lists of out-edges. Nodes are
+ * taken from a queue ordered by how much removing them would cost: the
+ * shortcuts they need, less the edges they take away, plus the neighbors
+ * already removed, which spreads removals evenly over the graph. A node's
+ * cost is checked again when it reaches the front of the queue and, if it
+ * has grown past the next node's, it goes back in. As each node is removed,
+ * its remaining arcs, all to higher nodes, become its final arcs.
+ * @param nodes  The number of nodes, numbered from 1.
+ * @param start  The first out-edge of each node, with start[nodes + 1] one
+ *               past the last edge.
+ * @param dest  The node each edge enters.
+ * @param cost  The cost of each edge.
+ * @pre Every cost is positive.
+ * @post The hierarchy answers queries on the graph.
+ */
+void ContractionHierarchy::build(int nodes, const vector<int>& start,
+                                 const vector<int>& dest,
+                                 const vector<int>& cost)
+{
+    vector<vector<Arc> > out(nodes + 1), in(nodes + 1);  // remaining graph
+    vector<char>         gone(nodes + 1, false);        // removed already
+    vector<int>          removed(nodes + 1, 0);         // neighbors removed
+    ArcHeap              order;                         // (cost, node) pairs
+    int v, next = 1;
+
+    size = nodes;
+    added = 0;
+    rank.assign(size + 1, 0);
+    aim.assign(size + 1, 0);
+
+    for (v = 1; v <= size; ++v)
+    {
+        for (int e = start[v]; e < start[v + 1]; ++e)
+        {
+            addArc(out[v], dest[e], cost[e], 0);
+            addArc(in[dest[e]], v, cost[e], 0);
+        } // end for (int e = start[v])
+    } // end for (v = 1)
+
+    for (v = 1; v <= size; ++v)
+    {
+        order.push(make_pair(contract(v, out, in, gone, false) -
+                             (int)(out[v].size() + in[v].size()), v));
+    } // end for (v = 1)
+
+    while(!order.empty())
+    {
+        int now;
+
+        v = order.top().second;
+        order.pop();
+        now = contract(v, out, in, gone, false) -
+              (int)(out[v].size() + in[v].size()) + removed[v];
+
+        if (!order.empty() && now > order.top().first)     // grown; requeue
+        {
+            order.push(make_pair(now, v));
+            continue;
+        } // end if (!order.empty() && now > order.top().first)
+
+        added += contract(v, out, in, gone, true);
+        gone[v] = true;
+        rank[v] = next++;
+
+        for (int i = 0; i < (int)out[v].size(); ++i)
+        {
+            dropArc(in[out[v][i].node], v);
+            ++removed[out[v][i].node];
+        } // end for (int i = 0)
+
+        for (int i = 0; i < (int)in[v].size(); ++i)
+        {
+            dropArc(out[in[v][i].node], v);
+            ++removed[in[v][i].node];
+        } // end for (int i = 0)
+    } // end while(!order.empty())
+
+    upStart.assign(size + 2, 0);
+    downStart.assign(size + 2, 0);
+    up.clear();
+    down.clear();
+
+    for (v = 1; v <= size; ++v)         // pack the final arcs
+    {
+        upStart[v] = (int)up.size();
+        downStart[v] = (int)down.size();
+        up.insert(up.end(), out[v].begin(), out[v].end());
+        down.insert(down.end(), in[v].begin(), in[v].end());
+        vector<Arc>().swap(out[v]);
+        vector<Arc>().swap(in[v]);
+    } // end for (v = 1)
+
+    upStart[size + 1] = (int)up.size();
+    downStart[size + 1] = (int)down.size();
+    vector<int>().swap(aim);
+    seekMark[0].clear();                // scratch is resized on next search
+} // end build(int, const vector<int>&, const vector<int>&, ...)
+
+/**---------------------- query() ---------------------------------------------
+ * Finds the shortest path between two nodes. A forward search from source
+ * follows arcs up to higher nodes, and a backward search from dest follows
+ * arcs down into it from higher nodes; the node where they meet at least
+ * total distance is the highest on the path. The next node settled is
+ * always the nearer of the two searches' fronts, and both stop once it is
+ * no nearer than the best meeting found. A node that a higher node already
+ * reached reaches more cheaply is not searched past, since no shortest path
+ * climbs through it. The path is then unpacked.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @param path  Receives the nodes on the path, from source to dest; empty if
+ *              there is none.
+ * @pre None.
+ * @post None.
+ * @return The length of the path, or INT_MAX if there is none or either node
+ *         is not in the graph.
+ */
+int ContractionHierarchy::query(int source, int dest, vector<int>& path)
+{
+    ArcHeap   heap[2];                  // forward and backward waiting nodes
+    long long best = LLONG_MAX;         // shortest meeting so far
+    int       meet = 0;                 // node where it meets
+    vector<int> leg;                    // forward half, back to front
+    int side, v, length;
+
+    path.clear();
+
+    if (source < 1 || source > size || dest < 1 || dest > size)
+    {
+        return INT_MAX;
+    } // end if (source < 1 || ...)
+
+    startSearch();
+    reach(0, source, 0, 0, 0, heap[0]);
+    reach(1, dest, 0, 0, 0, heap[1]);
+
+    while(!heap[0].empty() || !heap[1].empty())
+    {
+        side = (heap[1].empty() || (!heap[0].empty() &&
+                heap[0].top().first <= heap[1].top().first)) ? 0 : 1;
+        v = heap[side].top().second;
+        length = heap[side].top().first;
+        heap[side].pop();
+
+        if (length >= best)             // no nearer meeting is left
+        {
+            break;
+        }
+        else if (length != seekDist[side][v])   // made stale by relaxation
+        {
+            continue;
+        } // end if (length >= best)
+
+        if (seen(1 - side, v) && length + (long long)seekDist[1 - side][v] <
+                                 best)
+        {
+            best = length + (long long)seekDist[1 - side][v];
+            meet = v;
+        } // end if (seen(1 - side, v) && ...)
+
+        const vector<int>& first = (side == 0) ? upStart : downStart;
+        const vector<Arc>& arcs  = (side == 0) ? up : down;
+
+        if (stalled(side, v, length))
+        {
+            continue;
+        } // end if (stalled(side, v, length))
+
+        for (int a = first[v]; a < first[v + 1]; ++a)
+        {
+            reach(side, arcs[a].node, length + arcs[a].cost, v,
+                  arcs[a].middle, heap[side]);
+        } // end for (int a = first[v])
+    } // end while(!heap[0].empty() || !heap[1].empty())
+
+    if (meet == 0)
+    {
+        return INT_MAX;
+    } // end if (meet == 0)
+
+    for (v = meet; seekPrev[0][v] != 0; v = seekPrev[0][v])
+    {
+        leg.push_back(v);
+    } // end for (v = meet)
+
+    path.push_back(source);
+
+    for (int i = (int)leg.size() - 1; i >= 0; --i)      // source to meet
+    {
+        unpack(seekPrev[0][leg[i]], leg[i], seekVia[0][leg[i]], path);
+    } // end for (int i = (int)leg.size() - 1)
+
+    for (v = meet; seekPrev[1][v] != 0; v = seekPrev[1][v])  // meet to dest
+    {
+        unpack(v, seekPrev[1][v], seekVia[1][v], path);
+    } // end for (v = meet)
+
+    return (int)best;
+} // end query(int, int, vector<int>&)
+
+/**---------------------- table() ---------------------------------------------
+ * Finds the lengths of the shortest paths from each of a list of sources to
+ * each of a list of targets. Each target climbs backward once, and every
+ * node its climb settles gets a bucket entry holding the target and the
+ * distance. Each source then climbs forward once and, at every node it
+ * settles, adds its distance to each entry in that node's buckets. The
+ * highest node on a shortest path is settled by both climbs at its true
+ * distance, so the least such sum is the length of the path. Stalled nodes
+ * are left out of both, as their distances are too long to meet at. The
+ * climbs on each side are split over the workers.
+ * @param sources  The nodes from which paths start; one row each.
+ * @param targets  The nodes at which paths end; one column each.
+ * @param lengths  Receives the length of each path, row by row; INT_MAX
+ *                 where there is none or either node is not in the graph.
+ * @param pool  The workers to climb with; NULL to climb here.
+ * @pre None.
+ * @post None.
+ */
+void ContractionHierarchy::table(const vector<int>& sources,
+                                 const vector<int>& targets,
+                                 vector<int>& lengths, WorkPool* pool) const
+{
+    size_t cols = targets.size();
+    int    tasks = (pool == NULL ? 1 : pool->size());
+    vector<vector<Bucket> > found(tasks);   // entries from each task
+    vector<int>    bucketStart(size + 2, 0);    // first entry at each node
+    vector<int>    next;                        // next free entry, per node
+    vector<Bucket> buckets;                     // entries, by node
+
+    lengths.assign(sources.size() * cols, INT_MAX);
+
+    function<void(int)> climbTargets = [&](int task)
+    {
+        Climb search;
+
+        for (size_t j = task; j < cols; j += tasks)
+        {
+            if (targets[j] < 1 || targets[j] > size)
+            {
+                continue;
+            } // end if (targets[j] < 1 || ...)
+
+            climb(1, targets[j], search);
+
+            for (size_t k = 0; k < search.settled.size(); ++k)
+            {
+                int    v = search.settled[k];
+                Bucket entry = { v, (int)j, search.dist[v] };
+
+                found[task].push_back(entry);
+            } // end for (size_t k = 0)
+        } // end for (size_t j = task)
+    };
+
+    function<void(int)> climbSources = [&](int task)
+    {
+        Climb search;
+
+        for (size_t i = task; i < sources.size(); i += tasks)
+        {
+            int* row = &lengths[i * cols];
+
+            if (sources[i] < 1 || sources[i] > size)
+            {
+                continue;
+            } // end if (sources[i] < 1 || ...)
+
+            climb(0, sources[i], search);
+
+            for (size_t k = 0; k < search.settled.size(); ++k)
+            {
+                int v = search.settled[k];
+
+                for (int b = bucketStart[v]; b < bucketStart[v + 1]; ++b)
+                {
+                    long long length = (long long)search.dist[v] +
+                                       buckets[b].dist;
+
+                    if (length < row[buckets[b].column])
+                    {
+                        row[buckets[b].column] = (int)length;
+                    } // end if (length < row[buckets[b].column])
+                } // end for (int b = bucketStart[v])
+            } // end for (size_t k = 0)
+        } // end for (size_t i = task)
+    };
+
+    if (pool == NULL)
+    {
+        climbTargets(0);
+    }
+    else
+    {
+        pool->run(0, tasks - 1, climbTargets);
+    } // end if (pool == NULL)
+
+    for (int t = 0; t < tasks; ++t)         // count the entries at each node
+    {
+        for (size_t k = 0; k < found[t].size(); ++k)
+        {
+            ++bucketStart[found[t][k].node + 1];
+        } // end for (size_t k = 0)
+    } // end for (int t = 0)
+
+    for (int v = 1; v <= size + 1; ++v)
+    {
+        bucketStart[v] += bucketStart[v - 1];
+    } // end for (int v = 1)
+
+    buckets.resize(bucketStart[size + 1]);
+    next = bucketStart;
+
+    for (int t = 0; t < tasks; ++t)         // then place them, in node order
+    {
+        for (size_t k = 0; k < found[t].size(); ++k)
+        {
+            buckets[next[found[t][k].node]++] = found[t][k];
+        } // end for (size_t k = 0)
+
+        vector<Bucket>().swap(found[t]);
+    } // end for (int t = 0)
+
+    if (pool == NULL)
+    {
+        climbSources(0);
+    }
+    else
+    {
+        pool->run(0, tasks - 1, climbSources);
+    } // end if (pool == NULL)
+} // end table(const vector<int>&, const vector<int>&, ...)
+
+/**---------------------- nodes() ---------------------------------------------
+ * Reports the number of nodes in the hierarchy.
+ * @pre None.
+ * @post None.
+ * @return The number of nodes; 0 if it has not been built.
+ */
+int ContractionHierarchy::nodes(void) const
+{
+    return size;
+} // end nodes()
+
+/**---------------------- shortcuts() -----------------------------------------
+ * Reports the number of shortcuts preprocessing added.
+ * @pre None.
+ * @post None.
+ * @return The number of shortcuts.
+ */
+int ContractionHierarchy::shortcuts(void) const
+{
+    return added;
+} // end shortcuts()
+
+/**---------------------- bytes() ---------------------------------------------
+ * Reports the size of the index: the ranks and the packed arcs.
+ * @pre None.
+ * @post None.
+ * @return The bytes the index takes, not counting search scratch.
+ */
+size_t ContractionHierarchy::bytes(void) const
+{
+    return (rank.size() + upStart.size() + downStart.size()) * sizeof(int) +
+           (up.size() + down.size()) * sizeof(Arc);
+} // end bytes()
+
+/**---------------------- startSearch() ---------------------------------------
+ * Readies the scratch arrays for a new search. Entries are not cleared; each
+ * records the search that last set it, and older entries count as unset.
+ * @pre None.
+ * @post No node is reached by either side of the new search.
+ */
+void ContractionHierarchy::startSearch(void)
+{
+    if ((int)seekMark[0].size() != size + 1 || ++seekId == 0)
+    {
+        for (int side = 0; side < 2; ++side)
+        {
+            seekDist[side].assign(size + 1, INT_MAX);
+            seekPrev[side].assign(size + 1, 0);
+            seekVia[side].assign(size + 1, 0);
+            seekMark[side].assign(size + 1, 0);
+        } // end for (int side = 0)
+
+        seekId = 1;
+    } // end if ((int)seekMark[0].size() != size + 1 || ...)
+} // end startSearch()
+
+/**---------------------- seen() ----------------------------------------------
+ * Determines whether one side of the current search has reached a node.
+ * @param side  0 for the forward side; 1 for the backward side.
+ * @param v  The node in question.
+ * @pre startSearch() has been called since the hierarchy was built.
+ * @post None.
+ * @return true if the side has a distance for v; false, otherwise.
+ */
+bool ContractionHierarchy::seen(int side, int v) const
+{
+    return seekMark[side][v] == seekId;
+} // end seen(int, int)
+
+/**---------------------- reach() ---------------------------------------------
+ * Offers a path to a node during one side of the current search. A path
+ * shorter than the one known, or the first one found, is kept and the node
+ * is queued.
+ * @param side  0 for the forward side; 1 for the backward side.
+ * @param v  The node the path reaches.
+ * @param length  The length of the path.
+ * @param prev  The node before v on the path, toward where the side
+ *              started; 0 if v is where it started.
+ * @param via  The node skipped by the arc from prev, or 0 for an edge.
+ * @param heap  The nodes waiting on that side.
+ * @pre startSearch() has been called since the hierarchy was built.
+ * @post The side holds the better of the two paths to v.
+ */
+void ContractionHierarchy::reach(int side, int v, int length, int prev,
+                                 int via, ArcHeap& heap)
+{
+    if (!seen(side, v) || length < seekDist[side][v])
+    {
+        seekMark[side][v] = seekId;
+        seekDist[side][v] = length;
+        seekPrev[side][v] = prev;
+        seekVia[side][v] = via;
+        heap.push(make_pair(length, v));
+    } // end if (!seen(side, v) || ...)
+} // end reach(int, int, int, int, int, ArcHeap&)
+
+/**---------------------- stalled() -------------------------------------------
+ * Determines whether one side of the current search can skip the arcs of a
+ * node it has just settled, because some higher node it has reached has an
+ * arc to the node, or from it on the backward side, that is shorter than
+ * the distance settled. The node then lies on no shortest path the side
+ * could extend, though its distance may still be too long to meet at.
+ * @param side  0 for the forward side; 1 for the backward side.
+ * @param v  The node settled.
+ * @param length  Its distance from where the side started.
+ * @pre startSearch() has been called since the hierarchy was built.
+ * @post None.
+ * @return true if the arcs of v need not be followed; false, otherwise.
+ */
+bool ContractionHierarchy::stalled(int side, int v, int length) const
+{
+    const vector<int>& first = (side == 0) ? downStart : upStart;
+    const vector<Arc>& arcs  = (side == 0) ? down : up;
+
+    for (int a = first[v]; a < first[v + 1]; ++a)
+    {
+        int u = arcs[a].node;
+
+        if (seen(side, u) &&
+            (long long)seekDist[side][u] + arcs[a].cost < length)
+        {
+            return true;
+        } // end if (seen(side, u) && ...)
+    } // end for (int a = first[v])
+
+    return false;
+} // end stalled(int, int, int)
+
+/**---------------------- climb() ---------------------------------------------
+ * Searches upward from one node to every higher node it can reach, for a
+ * table. Unlike query(), it keeps its scratch in search, so climbs may run
+ * on several threads at once, and it reports the nodes it settled rather
+ * than a path. Entries the last climb in search reached are reset first.
+ * @param side  0 to follow arcs up from the node; 1 to follow arcs down
+ *              into it, backward.
+ * @param from  The node from which to climb.
+ * @param search  The scratch for the climb.
+ * @pre from is in the hierarchy.
+ * @post search.settled lists the nodes settled and not stalled, and
+ *       search.dist holds their distances from, or to, from.
+ */
+void ContractionHierarchy::climb(int side, int from, Climb& search) const
+{
+    const vector<int>& first = (side == 0) ? upStart : downStart;
+    const vector<Arc>& arcs  = (side == 0) ? up : down;
+    const vector<int>& above = (side == 0) ? downStart : upStart;
+    const vector<Arc>& into  = (side == 0) ? down : up;
+    ArcHeap heap;                       // (dist, node) pairs
+    int     v, w, length;
+    bool    stall;
+
+    if ((int)search.dist.size() != size + 1)
+    {
+        search.dist.assign(size + 1, INT_MAX);
+        search.reached.clear();
+    } // end if ((int)search.dist.size() != size + 1)
+
+    for (size_t k = 0; k < search.reached.size(); ++k)
+    {
+        search.dist[search.reached[k]] = INT_MAX;
+    } // end for (size_t k = 0)
+
+    search.reached.clear();
+    search.settled.clear();
+    search.dist[from] = 0;
+    search.reached.push_back(from);
+    heap.push(make_pair(0, from));
+
+    while(!heap.empty())
+    {
+        v = heap.top().second;
+        length = heap.top().first;
+        heap.pop();
+
+        if (length != search.dist[v])   // made stale by relaxation
+        {
+            continue;
+        } // end if (length != search.dist[v])
+
+        stall = false;                  // as in stalled()
+
+        for (int a = above[v]; !stall && a < above[v + 1]; ++a)
+        {
+            int u = into[a].node;
+
+            stall = search.dist[u] != INT_MAX &&
+                    (long long)search.dist[u] + into[a].cost < length;
+        } // end for (int a = above[v])
+
+        if (stall)
+        {
+            continue;
+        } // end if (stall)
+
+        search.settled.push_back(v);
+
+        for (int a = first[v]; a < first[v + 1]; ++a)
+        {
+            w = arcs[a].node;
+
+            if (search.dist[w] > length + arcs[a].cost)
+            {
+                if (search.dist[w] == INT_MAX)
+                {
+                    search.reached.push_back(w);
+                } // end if (search.dist[w] == INT_MAX)
+
+                search.dist[w] = length + arcs[a].cost;
+                heap.push(make_pair(search.dist[w], w));
+            } // end if (search.dist[w] > length + arcs[a].cost)
+        } // end for (int a = first[v])
+    } // end while(!heap.empty())
+} // end climb(int, int, Climb&)
+
+/**---------------------- witness() -------------------------------------------
+ * Searches the remaining graph from one node, avoiding the node about to be
+ * removed, for paths that make shortcuts around it unneeded. The search ends
+ * once every out-neighbor of that node is settled, and gives up past a
+ * distance limit or after settling WITNESSLIMIT nodes, in which case a
+ * shortcut may be added that was not strictly needed; that costs a little
+ * space but never a wrong answer.
+ * @param out  The out-arcs of the remaining graph.
+ * @param gone  Which nodes have been removed.
+ * @param from  The node to search from.
+ * @param skip  The node about to be removed.
+ * @param limit  The longest path of interest.
+ * @param targets  The number of out-neighbors of skip, each marked in aim.
+ * @pre None.
+ * @post The forward side of the scratch arrays holds the distances found.
+ */
+void ContractionHierarchy::witness(const vector<vector<Arc> >& out,
+                                   const vector<char>& gone, int from,
+                                   int skip, int limit, int targets)
+{
+    ArcHeap heap;
+    int     settled = 0;
+    int v, length;
+
+    startSearch();
+    reach(0, from, 0, 0, 0, heap);
+
+    while(!heap.empty() && settled < WITNESSLIMIT)
+    {
+        v = heap.top().second;
+        length = heap.top().first;
+        heap.pop();
+
+        if (length > limit)
+        {
+            break;
+        }
+        else if (length != seekDist[0][v])      // made stale by relaxation
+        {
+            continue;
+        } // end if (length > limit)
+
+        ++settled;
+
+        if (aim[v] == skip && --targets == 0)   // every target is settled
+        {
+            break;
+        } // end if (aim[v] == skip && ...)
+
+        for (int i = 0; i < (int)out[v].size(); ++i)
+        {
+            if (out[v][i].node != skip && !gone[out[v][i].node])
+            {
+                reach(0, out[v][i].node, length + out[v][i].cost, v, 0,
+                      heap);
+            } // end if (out[v][i].node != skip && ...)
+        } // end for (int i = 0)
+    } // end while(!heap.empty() && settled < WITNESSLIMIT)
+} // end witness(const vector<vector<Arc> >&, const vector<char>&, ...)
+
+/**---------------------- contract() ------------------------------------------
+ * Counts, and optionally adds, the shortcuts needed to remove a node: one
+ * from each node u entering it to each node w it enters, unless a witness
+ * search from u finds a path to w that avoids it and is no longer.
+ * @param v  The node to remove.
+ * @param out  The out-arcs of the remaining graph.
+ * @param in  The in-arcs of the remaining graph.
+ * @param gone  Which nodes have been removed.
+ * @param apply  true to add the shortcuts; false only to count them.
+ * @pre v has not been removed.
+ * @post If apply is true, the remaining graph without v keeps every
+ *       distance it had with v.
+ * @return The number of shortcuts needed.
+ */
+int ContractionHierarchy::contract(int v, vector<vector<Arc> >& out,
+                                   vector<vector<Arc> >& in,
+                                   const vector<char>& gone, bool apply)
+{
+    int needed = 0;
+
+    for (int j = 0; j < (int)out[v].size(); ++j)
+    {
+        aim[out[v][j].node] = v;
+    } // end for (int j = 0)
+
+    for (int i = 0; i < (int)in[v].size(); ++i)
+    {
+        int u = in[v][i].node, limit = 0;
+
+        for (int j = 0; j < (int)out[v].size(); ++j)
+        {
+            if (out[v][j].node != u)
+            {
+                limit = max(limit, in[v][i].cost + out[v][j].cost);
+            } // end if (out[v][j].node != u)
+        } // end for (int j = 0)
+
+        if (limit == 0)                 // v leads nowhere else from u
+        {
+            continue;
+        } // end if (limit == 0)
+
+        witness(out, gone, u, v, limit, (int)out[v].size());
+
+        for (int j = 0; j < (int)out[v].size(); ++j)
+        {
+            int w = out[v][j].node, via = in[v][i].cost + out[v][j].cost;
+
+            if (w != u && (!seen(0, w) || seekDist[0][w] > via))
+            {
+                ++needed;
+
+                if (apply)
+                {
+                    addArc(out[u], w, via, v);
+                    addArc(in[w], u, via, v);
+                } // end if (apply)
+            } // end if (w != u && ...)
+        } // end for (int j = 0)
+    } // end for (int i = 0)
+
+    return needed;
+} // end contract(int, vector<vector<Arc> >&, vector<vector<Arc> >&, ...)
+
+/**---------------------- addArc() --------------------------------------------
+ * Adds an arc to a list, or lowers the cost of the arc to the same node if
+ * the new one is cheaper.
+ * @param arcs  The list of arcs.
+ * @param node  The node at the other end.
+ * @param cost  The length of the arc.
+ * @param middle  The node a shortcut skips; 0 for an edge.
+ * @pre None.
+ * @post arcs holds one arc to node, the cheapest offered.
+ */
+void ContractionHierarchy::addArc(vector<Arc>& arcs, int node, int cost,
+                                  int middle)
+{
+    Arc arc = { node, cost, middle };
+
+    for (int i = 0; i < (int)arcs.size(); ++i)
+    {
+        if (arcs[i].node == node)
+        {
+            if (cost < arcs[i].cost)
+            {
+                arcs[i] = arc;
+            } // end if (cost < arcs[i].cost)
+
+            return;
+        } // end if (arcs[i].node == node)
+    } // end for (int i = 0)
+
+    arcs.push_back(arc);
+} // end addArc(vector<Arc>&, int, int, int)
+
+/**---------------------- dropArc() -------------------------------------------
+ * Removes the arc to a node from a list, if there is one.
+ * @param arcs  The list of arcs.
+ * @param node  The node at the other end.
+ * @pre None.
+ * @post arcs holds no arc to node.
+ */
+void ContractionHierarchy::dropArc(vector<Arc>& arcs, int node)
+{
+    for (int i = 0; i < (int)arcs.size(); ++i)
+    {
+        if (arcs[i].node == node)
+        {
+            arcs[i] = arcs.back();
+            arcs.pop_back();
+            return;
+        } // end if (arcs[i].node == node)
+    } // end for (int i = 0)
+} // end dropArc(vector<Arc>&, int)
+
+/**---------------------- middleOf() ------------------------------------------
+ * Finds the node skipped by one of a node's final arcs.
+ * @param start  The first arc of each node in arcs.
+ * @param arcs  The packed final arcs, up or down.
+ * @param at  The node whose arcs to look in.
+ * @param node  The node at the other end of the arc.
+ * @pre The arc exists.
+ * @post None.
+ * @return The node the arc skips; 0 if it is an edge.
+ */
+int ContractionHierarchy::middleOf(const vector<int>& start,
+                                   const vector<Arc>& arcs, int at,
+                                   int node) const
+{
+    for (int a = start[at]; a < start[at + 1]; ++a)
+    {
+        if (arcs[a].node == node)
+        {
+            return arcs[a].middle;
+        } // end if (arcs[a].node == node)
+    } // end for (int a = start[at])
+
+    return 0;
+} // end middleOf(const vector<int>&, const vector<Arc>&, int, int)
+
+/**---------------------- unpack() --------------------------------------------
+ * Appends the nodes an arc stands for, without recursion. A shortcut from u
+ * to w skipping m stands for the arc from u to m, found among the arcs into
+ * m from higher nodes, followed by the arc from m to w, found among the arcs
+ * out of m to higher nodes; m was removed before both, so both are there.
+ * @param from  The node at which the arc starts.
+ * @param to  The node at which the arc ends.
+ * @param middle  The node the arc skips; 0 for an edge.
+ * @param path  The path so far, ending at from.
+ * @pre The arc is in the hierarchy.
+ * @post path ends with the nodes after from on the arc, through to.
+ */
+void ContractionHierarchy::unpack(int from, int to, int middle,
+                                  vector<int>& path) const
+{
+    vector<Arc> stack;                  // arcs still to unpack; node holds
+    Arc         arc = { to, from, middle };     //  the end, cost the start
+
+    stack.push_back(arc);
+
+    while(!stack.empty())
+    {
+        arc = stack.back();
+        stack.pop_back();
+
+        if (arc.middle == 0)
+        {
+            path.push_back(arc.node);
+        }
+        else
+        {
+            Arc second = { arc.node, arc.middle,
+                           middleOf(upStart, up, arc.middle, arc.node) };
+            Arc first  = { arc.middle, arc.cost,
+                           middleOf(downStart, down, arc.middle, arc.cost) };
+
+            stack.push_back(second);    // unpacked after first
+            stack.push_back(first);
+        } // end if (arc.middle == 0)
+    } // end while(!stack.empty())
+} // end unpack(int, int, int, vector<int>&)
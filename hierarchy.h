@@ -0,0 +1,126 @@
+/*
+ * @file    hierarchy.h
+ * @brief   This class answers shortest path queries between pairs of nodes
+ *          with a contraction hierarchy. Preprocessing removes the nodes one
+ *          at a time, least important first, and wherever a removed node lay
+ *          on the only short path between two of its neighbors, adds a
+ *          shortcut edge between them that remembers the node it skips.
+ *          Each node's rank is its place in that order. A query then runs
+ *          two small searches that only ever climb in rank, one forward from
+ *          the source and one backward from the destination, and meets in
+ *          the middle; shortcuts on the resulting path are unpacked back
+ *          into the original nodes. Tables between many origins and
+ *          targets climb once from each target, leaving its distances in
+ *          buckets at the nodes it reaches, and once from each origin,
+ *          reading the buckets it meets. The index takes space in proportion
+ *          to the edges and shortcuts, not to the square of the node count.
+ */
+
+#ifndef _HIERARCHY_H
+#define	_HIERARCHY_H
+
+#include <climits>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <stdint.h>
+#include <vector>
+#include "workpool.h"
+
+using namespace std;
+const int WITNESSLIMIT = 500;   // most nodes a witness search may settle
+                                //  before a shortcut is added anyway
+
+
+class ContractionHierarchy
+{
+public:
+
+    ContractionHierarchy();
+
+    void build(int nodes, const vector<int>& start, const vector<int>& dest,
+               const vector<int>& cost);
+
+    int query(int source, int dest, vector<int>& path);
+
+    void table(const vector<int>& sources, const vector<int>& targets,
+               vector<int>& lengths, WorkPool* pool) const;
+
+    int nodes(void) const;
+
+    int shortcuts(void) const;
+
+    size_t bytes(void) const;
+
+private:
+
+    struct Arc
+    {
+        int node;               // node at the other end of the arc
+        int cost;               // length of the arc
+        int middle;             // node a shortcut skips; 0 for an edge
+    }; // end struct Arc
+
+    struct Bucket
+    {
+        int node;               // node where a target's climb settled
+        int column;             // the target's column
+        int dist;               // distance from the node to the target
+    }; // end struct Bucket
+
+    struct Climb
+    {
+        vector<int> dist;       // distance from where the climb started
+        vector<int> reached;    // nodes with a distance, to reset later
+        vector<int> settled;    // nodes settled and not stalled
+    }; // end struct Climb
+
+    typedef priority_queue<pair<int, int>, vector<pair<int, int> >,
+                           greater<pair<int, int> > > ArcHeap;
+
+    int         size;           // number of nodes
+    int         added;          // number of shortcuts
+    vector<int> rank;           // order in which each node was removed
+    vector<int> upStart;        // first arc to a higher node, per node
+    vector<Arc> up;             // arcs leaving each node for higher nodes
+    vector<int> downStart;      // first arc from a higher node, per node
+    vector<Arc> down;           // arcs entering each node from higher nodes;
+                                //  node is where the arc starts
+
+    vector<int>      seekDist[2];   // scratch for searches: distances,
+    vector<int>      seekPrev[2];   //  the node each was reached from,
+    vector<int>      seekVia[2];    //  the middle of the arc it came by,
+    vector<uint32_t> seekMark[2];   //  and the search that last set each
+    uint32_t         seekId;        // number of the current search
+    vector<int>      aim;           // node whose removal each node is an
+                                    //  out-neighbor of, while preprocessing
+
+    void startSearch(void);
+
+    bool seen(int side, int v) const;
+
+    void reach(int side, int v, int length, int prev, int via,
+               ArcHeap& heap);
+
+    bool stalled(int side, int v, int length) const;
+
+    void climb(int side, int from, Climb& search) const;
+
+    void witness(const vector<vector<Arc> >& out, const vector<char>& gone,
+                 int from, int skip, int limit, int targets);
+
+    int contract(int v, vector<vector<Arc> >& out, vector<vector<Arc> >& in,
+                 const vector<char>& gone, bool apply);
+
+    static void addArc(vector<Arc>& arcs, int node, int cost, int middle);
+
+    static void dropArc(vector<Arc>& arcs, int node);
+
+    int middleOf(const vector<int>& start, const vector<Arc>& arcs, int at,
+                 int node) const;
+
+    void unpack(int from, int to, int middle, vector<int>& path) const;
+
+}; // end class ContractionHierarchy
+
+#endif	/* _HIERARCHY_H */
@@ -10,24 +10,44 @@
 //   -- text files "data31.txt" and "data32.txt" are formatted as described
 //   -- Data file data3uwb provides an additional data set for part 1;
 //      it must be edited, as it starts with a description how to use it
+//
+// Usage: lab3 [-j threads]
+//   -j runs part 1 as a pipeline, solving graphs on that many threads
+//      (0 for one per core) while the next are parsed; output is unchanged
 //---------------------------------------------------------------------------
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include "batch.h"
 #include "graphl.h"
 #include "graphm.h"
 using namespace std;
 
-int main() {
+int main(int argc, char* argv[]) {
+   int jobs = 1;                   // solver threads for part 1
+   if (argc == 3 && strcmp(argv[1], "-j") == 0) {
+      jobs = atoi(argv[2]);
+   }
+   else if (argc != 1) {
+      cerr << "Usage: " << argv[0] << " [-j threads]" << endl;
+      return 1;
+   }
+
    // part 1
-   ifstream infile1("data31.txt");
+   GraphFile infile1("data31.txt");
    if (!infile1) {
       cout << "File could not be opened." << endl;
       return 1;
    }
 
    //for each graph, find the shortest path from every node to all other nodes
-   for(;;){
+   if (jobs != 1) {
+      GraphBatch batch(jobs, 0);   // same output, graphs solved in parallel
+      batch.run(infile1, cout);
+   }
+   while (jobs == 1) {
       GraphM G;
       G.buildGraph(infile1);
       if (infile1.eof())
@@ -39,7 +59,7 @@ int main() {
    }
 
    // part 2
-   ifstream infile2("data32.txt");
+   GraphFile infile2("data32.txt");
    if (!infile2) {
       cout << "File could not be opened." << endl;
       return 1;
@@ -0,0 +1,237 @@
+/*
+ * @file    nametable.cpp
+ * @brief   This class interns the descriptions of a graph's nodes. Every
+ *          distinct description is stored once, end to end with the others
+ *          in one block of characters, and each node keeps only the offset
+ *          and length of its own. A hash index maps each description back to
+ *          the lowest numbered node holding it.
+ */
+
+#include <cstring>
+#include "nametable.h"
+
+using namespace std;
+
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates a table holding only node 0.
+ * @pre None.
+ * @post The table holds no nodes.
+ */
+NameTable::NameTable()
+{
+    clear();
+} // end constructor
+
+/**---------------------- clear() ---------------------------------------------
+ * Forgets every node.
+ * @pre None.
+ * @post The table holds no nodes.
+ */
+void NameTable::clear(void)
+{
+    chars.clear();
+    offset.assign(1, 0);        // node 0 has the empty description
+    span.assign(1, 0);
+    slots.assign(16, 0);
+} // end clear()
+
+/**---------------------- reserve() -------------------------------------------
+ * Makes room for a number of nodes, so adding them never grows the index.
+ * @param names  The number of nodes expected.
+ * @pre None.
+ * @post Adding up to names nodes does not rehash.
+ */
+void NameTable::reserve(int names)
+{
+    offset.reserve(names + 1);
+    span.reserve(names + 1);
+
+    if ((size_t)names * 2 > slots.size())
+    {
+        rehash((size_t)names * 2);
+    } // end if ((size_t)names * 2 > slots.size())
+} // end reserve(int)
+
+/**---------------------- add() -----------------------------------------------
+ * Adds a node. If another node already has the same description, the new
+ * node shares its characters.
+ * @param name  The description of the node.
+ * @pre The block of characters stays under 4 GB.
+ * @post The node is the highest numbered in the table.
+ * @return The number of the new node.
+ */
+int NameTable::add(const string& name)
+{
+    int id = (int)offset.size();
+    int slot = slotOf(name.data(), name.size());
+
+    if (slots[slot] != 0)               // seen before; share its text
+    {
+        offset.push_back(offset[slots[slot]]);
+        span.push_back(span[slots[slot]]);
+        return id;
+    } // end if (slots[slot] != 0)
+
+    offset.push_back((uint32_t)chars.size());
+    span.push_back((uint32_t)name.size());
+    chars.insert(chars.end(), name.begin(), name.end());
+    slots[slot] = id;
+
+    if (4 * (size_t)id > 3 * slots.size())      // keep the index sparse
+    {
+        rehash(slots.size() * 2);
+    } // end if (4 * (size_t)id > 3 * slots.size())
+
+    return id;
+} // end add(const string&)
+
+/**---------------------- size() ----------------------------------------------
+ * Reports the number of nodes.
+ * @pre None.
+ * @post None.
+ * @return The number of the highest numbered node; 0 if there are none.
+ */
+int NameTable::size(void) const
+{
+    return (int)offset.size() - 1;
+} // end size()
+
+/**---------------------- text() ----------------------------------------------
+ * Finds the characters of a node's description, which are not terminated.
+ * @param id  The number of the node.
+ * @pre id is from 0 to size().
+ * @post None.
+ * @return The first of length(id) characters, valid until the next add().
+ */
+const char* NameTable::text(int id) const
+{
+    return chars.empty() ? "" : &chars[0] + offset[id];
+} // end text(int)
+
+/**---------------------- length() --------------------------------------------
+ * Finds the length of a node's description.
+ * @param id  The number of the node.
+ * @pre id is from 0 to size().
+ * @post None.
+ * @return The number of characters in the description.
+ */
+int NameTable::length(int id) const
+{
+    return (int)span[id];
+} // end length(int)
+
+/**---------------------- name() ----------------------------------------------
+ * Copies a node's description.
+ * @param id  The number of the node.
+ * @pre id is from 0 to size().
+ * @post None.
+ * @return The description.
+ */
+string NameTable::name(int id) const
+{
+    return string(text(id), length(id));
+} // end name(int)
+
+/**---------------------- find() ----------------------------------------------
+ * Finds the node with a description, without searching every node.
+ * @param name  The description to look for.
+ * @pre None.
+ * @post None.
+ * @return The lowest numbered node with that description; 0 if none has it.
+ */
+int NameTable::find(const string& name) const
+{
+    return slots[slotOf(name.data(), name.size())];
+} // end find(const string&)
+
+/**---------------------- bytes() ---------------------------------------------
+ * Reports the memory the table holds.
+ * @pre None.
+ * @post None.
+ * @return The bytes reserved for characters, offsets, lengths and index.
+ */
+size_t NameTable::bytes(void) const
+{
+    return chars.capacity() + (offset.capacity() + span.capacity()) *
+           sizeof(uint32_t) + slots.capacity() * sizeof(int);
+} // end bytes()
+
+/**---------------------- hashOf() --------------------------------------------
+ * Hashes a description with 64-bit FNV-1a.
+ * @param text  The characters of the description.
+ * @param length  The number of characters.
+ * @pre None.
+ * @post None.
+ * @return The hash.
+ */
+uint64_t NameTable::hashOf(const char* text, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash = (hash ^ (unsigned char)text[i]) * 1099511628211ULL;
+    } // end for (size_t i = 0)
+
+    return hash;
+} // end hashOf(const char*, size_t)
+
+/**---------------------- slotOf() --------------------------------------------
+ * Finds the slot of the index that holds a description, or the empty slot
+ * where it belongs. Collisions probe the following slots in turn.
+ * @param text  The characters of the description.
+ * @param length  The number of characters.
+ * @pre The index has at least one empty slot.
+ * @post None.
+ * @return The position of the slot in the index.
+ */
+int NameTable::slotOf(const char* text, size_t length) const
+{
+    size_t mask = slots.size() - 1;
+    size_t slot = hashOf(text, length) & mask;
+
+    while(slots[slot] != 0)
+    {
+        int id = slots[slot];
+
+        if (span[id] == length &&
+            (length == 0 || memcmp(&chars[offset[id]], text, length) == 0))
+        {
+            break;
+        } // end if (span[id] == length && ...)
+
+        slot = (slot + 1) & mask;
+    } // end while(slots[slot] != 0)
+
+    return (int)slot;
+} // end slotOf(const char*, size_t)
+
+/**---------------------- rehash() --------------------------------------------
+ * Rebuilds the index with more slots.
+ * @param count  The least number of slots wanted.
+ * @pre None.
+ * @post The index has a power of two slots, at least count, and holds every
+ *       distinct description.
+ */
+void NameTable::rehash(size_t count)
+{
+    size_t total = 16;
+
+    while(total < count)
+    {
+        total *= 2;
+    } // end while(total < count)
+
+    slots.assign(total, 0);
+
+    for (int id = 1; id < (int)offset.size(); ++id)
+    {
+        int slot = slotOf(text(id), span[id]);
+
+        if (slots[slot] == 0)           // keep the lowest numbered node
+        {
+            slots[slot] = id;
+        } // end if (slots[slot] == 0)
+    } // end for (int id = 1)
+} // end rehash(size_t)
@@ -0,0 +1,62 @@
+/*
+ * @file    nametable.h
+ * @brief   This class interns the descriptions of a graph's nodes. Every
+ *          distinct description is stored once, end to end with the others
+ *          in one block of characters, and each node keeps only the offset
+ *          and length of its own, so a node costs eight bytes however long
+ *          its description. A hash index maps each description back to the
+ *          lowest numbered node holding it. Nodes are numbered from 1 in the
+ *          order they are added; node 0 has the empty description.
+ */
+
+#ifndef _NAMETABLE_H
+#define	_NAMETABLE_H
+
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+class NameTable
+{
+public:
+
+    NameTable();
+
+    void clear(void);
+
+    void reserve(int names);
+
+    int add(const string& name);
+
+    int size(void) const;
+
+    const char* text(int id) const;
+
+    int length(int id) const;
+
+    string name(int id) const;
+
+    int find(const string& name) const;
+
+    size_t bytes(void) const;
+
+private:
+
+    vector<char>     chars;     // every distinct name, end to end
+    vector<uint32_t> offset;    // where each node's name starts in chars
+    vector<uint32_t> span;      // length of each node's name
+    vector<int>      slots;     // open hash of node ids; 0 for an empty slot
+
+    static uint64_t hashOf(const char* text, size_t length);
+
+    int slotOf(const char* text, size_t length) const;
+
+    void rehash(size_t count);
+
+}; // end class NameTable
+
+#endif	/* _NAMETABLE_H */
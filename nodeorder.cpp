@@ -0,0 +1,188 @@
+/*
+ * @file    nodeorder.cpp
+ * @brief   These routines choose a new numbering for the nodes of a graph so
+ *          that nodes joined by edges get nearby numbers. Edges are taken in
+ *          both directions when ordering.
+ */
+
+#include <algorithm>
+#include "nodeorder.h"
+
+using namespace std;
+
+
+/**---------------------- linkBoth() ------------------------------------------
+ * Builds lists of the nodes joined to each node by an edge in either
+ * direction, each list in increasing order with no repeats.
+ * @param nodes  The number of nodes, numbered from 1.
+ * @param start  The first out-edge of each node, with start[nodes + 1] one
+ *               past the last edge.
+ * @param dest  The node each edge enters.
+ * @param around  Receives the first neighbor of each node, with
+ *                around[nodes + 1] one past the last.
+ * @param next  Receives the neighbors of each node.
+ * @pre None.
+ * @post around and next list the neighbors of every node.
+ */
+static void linkBoth(int nodes, const vector<int>& start,
+                     const vector<int>& dest, vector<int>& around,
+                     vector<int>& next)
+{
+    vector<int> slot;                   // next free place in each list
+    int v;
+
+    around.assign(nodes + 2, 0);
+
+    for (v = 1; v <= nodes; ++v)
+    {
+        for (int e = start[v]; e < start[v + 1]; ++e)
+        {
+            ++around[v + 1];
+            ++around[dest[e] + 1];
+        } // end for (int e = start[v])
+    } // end for (v = 1)
+
+    for (v = 1; v <= nodes + 1; ++v)
+    {
+        around[v] += around[v - 1];
+    } // end for (v = 1)
+
+    slot.assign(around.begin(), around.end() - 1);
+    next.resize(around[nodes + 1]);
+
+    for (v = 1; v <= nodes; ++v)
+    {
+        for (int e = start[v]; e < start[v + 1]; ++e)
+        {
+            next[slot[v]++] = dest[e];
+            next[slot[dest[e]]++] = v;
+        } // end for (int e = start[v])
+    } // end for (v = 1)
+
+    for (v = 1; v <= nodes; ++v)        // sort each list, drop repeats
+    {
+        vector<int>::iterator first = next.begin() + around[v];
+        vector<int>::iterator last  = next.begin() + around[v + 1];
+
+        sort(first, last);
+        slot[v] = (int)(unique(first, last) - next.begin());
+    } // end for (v = 1)
+
+    int kept = 0;
+
+    for (v = 1; v <= nodes; ++v)        // close the gaps repeats left
+    {
+        int from = around[v];
+
+        around[v] = kept;
+
+        for (int i = from; i < slot[v]; ++i)
+        {
+            next[kept++] = next[i];
+        } // end for (int i = from)
+    } // end for (v = 1)
+
+    around[nodes + 1] = kept;
+    next.resize(kept);
+} // end linkBoth(int, const vector<int>&, const vector<int>&, ...)
+
+/**---------------------- orderNodes() ----------------------------------------
+ * Chooses a new numbering for the nodes of a graph. BFS_ORDER numbers nodes
+ * as a breadth-first search finds them, from each unnumbered node in turn,
+ * lowest first. RCM_ORDER does the same from a node of least degree in each
+ * part of the graph, taking each node's neighbors in order of degree, and
+ * then reverses the whole numbering; the nonzero entries of the matrix then
+ * lie in a narrow band about the diagonal. DEGREE_ORDER numbers the nodes
+ * with the most edges first. Ties always go to the lower numbered node.
+ * @param order  The numbering to choose.
+ * @param nodes  The number of nodes, numbered from 1.
+ * @param start  The first out-edge of each node, with start[nodes + 1] one
+ *               past the last edge.
+ * @param dest  The node each edge enters.
+ * @pre None.
+ * @post None.
+ * @return For each new number from 1 to nodes, the node's present number;
+ *         element 0 is 0. INPUT_ORDER keeps every node's number.
+ */
+vector<int> orderNodes(NodeOrder order, int nodes, const vector<int>& start,
+                       const vector<int>& dest)
+{
+    vector<int>  result(1, 0);          // new number to present number
+    vector<int>  around, next;          // neighbors in either direction
+    vector<int>  byDegree;              // nodes, fewest neighbors first
+    vector<char> numbered(nodes + 1, false);
+
+    result.reserve(nodes + 1);
+
+    if (order == INPUT_ORDER)
+    {
+        for (int v = 1; v <= nodes; ++v)
+        {
+            result.push_back(v);
+        } // end for (int v = 1)
+
+        return result;
+    } // end if (order == INPUT_ORDER)
+
+    linkBoth(nodes, start, dest, around, next);
+
+    for (int v = 1; v <= nodes; ++v)
+    {
+        byDegree.push_back(v);
+    } // end for (int v = 1)
+
+    if (order == DEGREE_ORDER)
+    {
+        stable_sort(byDegree.begin(), byDegree.end(), [&](int v, int w)
+            { return around[v + 1] - around[v] > around[w + 1] - around[w]; });
+        result.insert(result.end(), byDegree.begin(), byDegree.end());
+        return result;
+    } // end if (order == DEGREE_ORDER)
+
+    if (order == RCM_ORDER)
+    {
+        stable_sort(byDegree.begin(), byDegree.end(), [&](int v, int w)
+            { return around[v + 1] - around[v] < around[w + 1] - around[w]; });
+    } // end if (order == RCM_ORDER)
+
+    for (int s = 0; s < nodes; ++s)     // result doubles as the queue
+    {
+        int head = (int)result.size();
+
+        if (numbered[byDegree[s]])
+        {
+            continue;
+        } // end if (numbered[byDegree[s]])
+
+        numbered[byDegree[s]] = true;
+        result.push_back(byDegree[s]);
+
+        for (; head < (int)result.size(); ++head)
+        {
+            int v = result[head], found = (int)result.size();
+
+            for (int i = around[v]; i < around[v + 1]; ++i)
+            {
+                if (!numbered[next[i]])
+                {
+                    numbered[next[i]] = true;
+                    result.push_back(next[i]);
+                } // end if (!numbered[next[i]])
+            } // end for (int i = around[v])
+
+            if (order == RCM_ORDER)
+            {
+                stable_sort(result.begin() + found, result.end(),
+                            [&](int x, int y) { return around[x + 1] -
+                                around[x] < around[y + 1] - around[y]; });
+            } // end if (order == RCM_ORDER)
+        } // end for (; head < (int)result.size(); ++head)
+    } // end for (int s = 0)
+
+    if (order == RCM_ORDER)
+    {
+        reverse(result.begin() + 1, result.end());
+    } // end if (order == RCM_ORDER)
+
+    return result;
+} // end orderNodes(NodeOrder, int, const vector<int>&, const vector<int>&)
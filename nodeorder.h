@@ -0,0 +1,29 @@
+/*
+ * @file    nodeorder.h
+ * @brief   These routines choose a new numbering for the nodes of a graph so
+ *          that nodes joined by edges get nearby numbers. Rows of a matrix and
+ *          lists of edges are stored in node order, so searches that move
+ *          from a node to its neighbors then touch memory that is close
+ *          together. Edges are taken in both directions when ordering.
+ */
+
+#ifndef _NODEORDER_H
+#define	_NODEORDER_H
+
+#include <vector>
+
+using namespace std;
+
+
+enum NodeOrder
+{
+    INPUT_ORDER,        // numbered as in the input
+    BFS_ORDER,          // breadth-first from each unnumbered node in turn
+    RCM_ORDER,          // reverse Cuthill-McKee, which narrows the bandwidth
+    DEGREE_ORDER        // most edges first, so the busiest rows sit together
+}; // end enum NodeOrder
+
+vector<int> orderNodes(NodeOrder order, int nodes, const vector<int>& start,
+                       const vector<int>& dest);
+
+#endif	/* _NODEORDER_H */
@@ -0,0 +1,187 @@
+/*
+ * @file    pathcache.cpp
+ * @brief   This class keeps the node lists of recently fetched shortest paths,
+ *          keyed by their source and destination, so a path asked for again
+ *          is copied out instead of walked again. Only a fixed number of
+ *          paths are kept; when full, the one used least recently is evicted
+ *          and its storage is reused for the newcomer. A cache of no entries
+ *          keeps nothing.
+ */
+
+#include "pathcache.h"
+
+using namespace std;
+
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates a cache that keeps nothing until it is resized.
+ * @pre None.
+ * @post An empty cache of no entries exists.
+ */
+PathCache::PathCache() : limit(0)
+{
+} // end constructor
+
+/**---------------------- Copy Constructor ------------------------------------
+ * Creates a cache holding the same paths as another, in the same order of
+ * use. The index is rebuilt so it refers to this cache's own entries.
+ * @param other  The cache to copy.
+ * @pre None.
+ * @post This cache keeps what other keeps, with no spare storage.
+ */
+PathCache::PathCache(const PathCache& other) : limit(other.limit),
+    used(other.used)
+{
+    reindex();
+} // end copy constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Destroys the cache and every path in it.
+ * @pre None.
+ * @post All memory is freed.
+ */
+PathCache::~PathCache()
+{
+} // end destructor
+
+/**---------------------- operator=() -----------------------------------------
+ * Makes this cache hold the same paths as another, in the same order of
+ * use. The index is rebuilt so it refers to this cache's own entries.
+ * @param other  The cache to copy.
+ * @pre None.
+ * @post This cache keeps what other keeps, with no spare storage.
+ * @return This cache, for chaining.
+ */
+PathCache& PathCache::operator=(const PathCache& other)
+{
+    if (this != &other)
+    {
+        limit = other.limit;
+        used = other.used;
+        spare.clear();
+        reindex();
+    } // end if (this != &other)
+
+    return *this;
+} // end operator=(const PathCache&)
+
+/**---------------------- resize() --------------------------------------------
+ * Sets the number of paths the cache may keep, and empties it.
+ * @param entries  The most paths to keep; 0 or less keeps none.
+ * @pre None.
+ * @post The cache is empty and keeps up to entries paths.
+ */
+void PathCache::resize(int entries)
+{
+    limit = (entries > 0) ? entries : 0;
+    used.clear();
+    spare.clear();
+    index.clear();
+    index.reserve(limit);
+} // end resize(int)
+
+/**---------------------- capacity() ------------------------------------------
+ * Reports the number of paths the cache may keep.
+ * @pre None.
+ * @post None.
+ * @return The most paths kept at once; 0 if the cache is off.
+ */
+int PathCache::capacity(void) const
+{
+    return limit;
+} // end capacity()
+
+/**---------------------- find() ----------------------------------------------
+ * Looks up a path, marking it as the most recently used.
+ * @param source  The node at which the path starts.
+ * @param dest  The node at which the path ends.
+ * @pre None.
+ * @post If the path is kept, it is the last that will be evicted.
+ * @return The nodes on the path, valid until the cache next changes; NULL if
+ *         the path is not kept.
+ */
+const vector<int>* PathCache::find(int source, int dest)
+{
+    unordered_map<uint64_t, EntryList::iterator>::iterator found =
+            index.find(keyOf(source, dest));
+
+    if (found == index.end())
+    {
+        return NULL;
+    } // end if (found == index.end())
+
+    used.splice(used.begin(), used, found->second);     // now the newest
+    return &found->second->nodes;
+} // end find(int, int)
+
+/**---------------------- insert() --------------------------------------------
+ * Makes room for a path, evicting the least recently used one if the cache
+ * is full. The caller fills in the nodes.
+ * @param source  The node at which the path starts.
+ * @param dest  The node at which the path ends.
+ * @pre The path is not kept already, and the cache keeps at least one path.
+ * @post The path is kept as the most recently used, with its nodes empty but
+ *       the storage of an evicted path, if any, still reserved.
+ * @return The list into which to write the nodes on the path.
+ */
+vector<int>& PathCache::insert(int source, int dest)
+{
+    if ((int)used.size() >= limit)      // evict the oldest
+    {
+        index.erase(used.back().key);
+        spare.splice(spare.begin(), used, --used.end());
+    } // end if ((int)used.size() >= limit)
+
+    if (spare.empty())
+    {
+        spare.push_back(Entry());
+    } // end if (spare.empty())
+
+    used.splice(used.begin(), spare, spare.begin());
+    used.front().key = keyOf(source, dest);
+    used.front().nodes.clear();
+    index[used.front().key] = used.begin();
+
+    return used.front().nodes;
+} // end insert(int, int)
+
+/**---------------------- clear() ---------------------------------------------
+ * Forgets every path, keeping their storage for later paths.
+ * @pre None.
+ * @post No path is kept.
+ */
+void PathCache::clear(void)
+{
+    spare.splice(spare.begin(), used);
+    index.clear();
+} // end clear()
+
+/**---------------------- keyOf() ---------------------------------------------
+ * Combines the two ends of a path into one key.
+ * @param source  The node at which the path starts.
+ * @param dest  The node at which the path ends.
+ * @pre None.
+ * @post None.
+ * @return A key unique to the pair.
+ */
+uint64_t PathCache::keyOf(int source, int dest)
+{
+    return (uint64_t)(uint32_t)source << 32 | (uint32_t)dest;
+} // end keyOf(int, int)
+
+/**---------------------- reindex() -------------------------------------------
+ * Rebuilds the index from the kept entries.
+ * @pre None.
+ * @post The index maps the key of every kept entry to that entry.
+ */
+void PathCache::reindex(void)
+{
+    index.clear();
+    index.reserve(limit);
+
+    for (EntryList::iterator entry = used.begin(); entry != used.end();
+         ++entry)
+    {
+        index[entry->key] = entry;
+    } // end for (EntryList::iterator entry = used.begin())
+} // end reindex()
@@ -0,0 +1,66 @@
+/*
+ * @file    pathcache.h
+ * @brief   This class keeps the node lists of recently fetched shortest paths,
+ *          keyed by their source and destination, so a path asked for again
+ *          is copied out instead of walked again. Only a fixed number of
+ *          paths are kept; when full, the one used least recently is evicted
+ *          and its storage is reused for the newcomer. A cache of no entries
+ *          keeps nothing.
+ */
+
+#ifndef _PATHCACHE_H
+#define	_PATHCACHE_H
+
+#include <cstdlib>
+#include <list>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+
+class PathCache
+{
+public:
+
+    PathCache();
+
+    PathCache(const PathCache& other);
+
+    virtual ~PathCache();
+
+    PathCache& operator=(const PathCache& other);
+
+    void resize(int entries);
+
+    int capacity(void) const;
+
+    const vector<int>* find(int source, int dest);
+
+    vector<int>& insert(int source, int dest);
+
+    void clear(void);
+
+private:
+
+    struct Entry
+    {
+        uint64_t    key;        // source and destination of the path
+        vector<int> nodes;      // nodes on the path, source first
+    }; // end struct Entry
+
+    typedef list<Entry> EntryList;
+
+    int                                          limit;  // most entries kept
+    EntryList                                    used;   // newest first
+    EntryList                                    spare;  // emptied entries
+    unordered_map<uint64_t, EntryList::iterator> index;  // entry of each key
+
+    static uint64_t keyOf(int source, int dest);
+
+    void reindex(void);
+
+}; // end class PathCache
+
+#endif	/* _PATHCACHE_H */
@@ -0,0 +1,536 @@
+/*
+ * @file    pathfile.cpp
+ * @brief   This class keeps the shortest paths between all pairs of nodes in
+ *          a file instead of in memory. Rows are found a block at a time,
+ *          one source per task, and written out as each block completes, so
+ *          finding them takes memory for one block and the edges rather than
+ *          for the whole table. The file is a fixed header followed by one
+ *          row per source node, in node order: the distance to every node,
+ *          then the node before it on the path. Distances and nodes are
+ *          narrowed to two bytes each when every value in the file fits.
+ *          Queries read the file through a memory mapping, so only the rows
+ *          asked for are paged in, and the system may drop them again as it
+ *          needs room.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "dijkstra.h"
+#include "pathfile.h"
+
+using namespace std;
+
+
+/**---------------------- putValue() ------------------------------------------
+ * Stores a distance or node in a row, narrowed to the row's width. INT_MAX,
+ * for no path, is stored with every bit set.
+ * @param at  Where to store the value.
+ * @param width  The bytes in each value, 2 or 4.
+ * @param value  The value, which fits the width unless it is INT_MAX.
+ * @pre None.
+ * @post The value is stored at at.
+ */
+static void putValue(char* at, uint32_t width, int value)
+{
+    if (width == 2)
+    {
+        uint16_t narrow = (value == INT_MAX ? 0xFFFF : (uint16_t)value);
+
+        memcpy(at, &narrow, 2);
+    }
+    else
+    {
+        uint32_t wide = (value == INT_MAX ? 0xFFFFFFFF : (uint32_t)value);
+
+        memcpy(at, &wide, 4);
+    } // end if (width == 2)
+} // end putValue(char*, uint32_t, int)
+
+/**---------------------- getValue() ------------------------------------------
+ * Reads back a value stored by putValue().
+ * @param at  Where the value is stored.
+ * @param width  The bytes in each value, 2 or 4.
+ * @pre None.
+ * @post None.
+ * @return The value, or INT_MAX if every bit is set.
+ */
+static int getValue(const char* at, uint32_t width)
+{
+    if (width == 2)
+    {
+        uint16_t narrow;
+
+        memcpy(&narrow, at, 2);
+        return (narrow == 0xFFFF ? INT_MAX : narrow);
+    }
+    else
+    {
+        uint32_t wide;
+
+        memcpy(&wide, at, 4);
+        return (wide == 0xFFFFFFFF ? INT_MAX : (int)wide);
+    } // end if (width == 2)
+} // end getValue(const char*, uint32_t)
+
+/**---------------------- Constructor -----------------------------------------
+ * Creates a path file reader with no file open.
+ * @pre None.
+ * @post No file is open; every query finds no path.
+ */
+PathFile::PathFile() : rows(NULL), mapped(NULL), length(0)
+{
+    memset(&head, 0, sizeof(head));
+} // end constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Unmaps the file.
+ * @pre None.
+ * @post All memory is freed.
+ */
+PathFile::~PathFile()
+{
+    close();
+} // end destructor
+
+/**---------------------- write() ---------------------------------------------
+ * Finds the shortest paths from every node to every other node and writes
+ * them to a path file. Rows are found with dijkstra(), as GraphM's heap
+ * engine finds them, so the file holds the same paths as the path matrix.
+ * Rows are found a block of about PATHBLOCK bytes at a time, spread over the
+ * workers, and each block is written before the next is started. Narrow
+ * distances are tried whenever asked for, since the longest shortest path is
+ * usually far shorter than any bound the costs give; if a row turns out to
+ * hold a distance that does not fit, the file is started again with
+ * four-byte distances, at worst finding the rows before it twice.
+ * @param name  The path of the file to write.
+ * @param nodes  The number of nodes, numbered from 1.
+ * @param start  The first out-edge of each node, with start[nodes + 1] one
+ *               past the last edge.
+ * @param dest  The node each edge enters.
+ * @param cost  The cost of each edge; all are positive.
+ * @param narrow  true to store distances and nodes in two bytes wherever
+ *                every value fits.
+ * @param threads  The number of workers to find rows with.
+ * @pre None.
+ * @post The file holds every shortest path of the graph, or is incomplete
+ *       and will not open.
+ * @return true if the file was written in full; false, otherwise.
+ */
+bool PathFile::write(const char* name, int nodes, const vector<int>& start,
+                     const vector<int>& dest, const vector<int>& cost,
+                     bool narrow, int threads)
+{
+    PathFileHeader header;
+    WorkPool*      pool = NULL;
+    uint64_t       longest;             // no path can be longer than this
+    bool           fits, good;
+
+    if (nodes < 1 || (int)start.size() < nodes + 2)
+    {
+        return false;
+    } // end if (nodes < 1 || ...)
+
+    longest = (cost.empty() ? 0 : *max_element(cost.begin(), cost.end()));
+    longest *= nodes - 1;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PATHMAGIC, sizeof(header.magic));
+    header.version = PATHVERSION;
+    header.byteOrder = PATHORDER;
+    header.headerBytes = sizeof(header);
+    header.nodes = nodes;
+    header.distWidth = (narrow ? 2 : 4);
+    header.prevWidth = (narrow && nodes < 0xFFFF ? 2 : 4);
+
+    if (threads > 1)
+    {
+        pool = new WorkPool(threads);
+    } // end if (threads > 1)
+
+    do
+    {
+        ofstream output(name, ios::out | ios::binary | ios::trunc);
+
+        header.rowBytes = rowBytesOf(header);
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        fits = writeRows(output, header, start, dest, cost, longest, pool);
+        output.close();
+        good = !output.fail();
+        header.distWidth = 4;           // if the rows did not fit
+    } while(good && !fits);
+
+    delete pool;
+    return good;
+} // end write(const char*, int, const vector<int>&, ...)
+
+/**---------------------- open() ----------------------------------------------
+ * Opens a path file written by write() and maps it into memory. Nothing is
+ * read beyond the header until it is asked for.
+ * @param name  The path of the file to read.
+ * @pre None.
+ * @post If the file is complete and of this version, queries read it.
+ *       Otherwise no file is open.
+ * @return true if the file was opened; false, otherwise.
+ */
+bool PathFile::open(const char* name)
+{
+    int         fd = ::open(name, O_RDONLY);
+    struct stat info;
+
+    close();
+
+    if (fd < 0)             // file does not exist or cannot be read
+    {
+        return false;
+    } // end if (fd < 0)
+
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) &&
+        (size_t)info.st_size >= sizeof(head))
+    {
+        length = info.st_size;
+        mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapped == MAP_FAILED)
+        {
+            mapped = NULL;
+            length = 0;
+        } // end if (mapped == MAP_FAILED)
+    } // end if (fstat(fd, &info) == 0 && ...)
+
+    ::close(fd);
+
+    if (mapped == NULL)
+    {
+        return false;
+    } // end if (mapped == NULL)
+
+    memcpy(&head, mapped, sizeof(head));
+
+    if (memcmp(head.magic, PATHMAGIC, sizeof(head.magic)) != 0 ||
+        head.version != PATHVERSION || head.byteOrder != PATHORDER ||
+        head.headerBytes != sizeof(head) || head.nodes < 1 ||
+        (head.distWidth != 2 && head.distWidth != 4) ||
+        (head.prevWidth != 2 && head.prevWidth != 4) ||
+        head.rowBytes != rowBytesOf(head) ||
+        length < head.headerBytes + head.nodes * head.rowBytes)
+    {
+        close();
+        return false;
+    } // end if (memcmp(head.magic, PATHMAGIC, ...) != 0 || ...)
+
+    madvise(mapped, length, MADV_RANDOM);   // rows are read as asked for
+    rows = static_cast<const char*>(mapped) + head.headerBytes;
+    return true;
+} // end open(const char*)
+
+/**---------------------- close() ---------------------------------------------
+ * Unmaps the open file, if any.
+ * @pre None.
+ * @post No file is open; every query finds no path.
+ */
+void PathFile::close(void)
+{
+    if (mapped != NULL)
+    {
+        munmap(mapped, length);
+    } // end if (mapped != NULL)
+
+    memset(&head, 0, sizeof(head));
+    rows = NULL;
+    mapped = NULL;
+    length = 0;
+} // end close()
+
+/**---------------------- nodes() ---------------------------------------------
+ * Reports the number of nodes in the open file.
+ * @pre None.
+ * @post None.
+ * @return The number of nodes; 0 if no file is open.
+ */
+int PathFile::nodes(void) const
+{
+    return head.nodes;
+} // end nodes()
+
+/**---------------------- header() --------------------------------------------
+ * Gives read access to the header of the open file, for its widths.
+ * @pre None.
+ * @post None.
+ * @return The header; all zero if no file is open.
+ */
+const PathFileHeader& PathFile::header(void) const
+{
+    return head;
+} // end header()
+
+/**---------------------- distance() ------------------------------------------
+ * Reads the length of the shortest path between two nodes. Only the row for
+ * source is touched.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @pre None.
+ * @post None.
+ * @return The length of the path, or INT_MAX if there is none or either node
+ *         is not in the file.
+ */
+int PathFile::distance(int source, int dest) const
+{
+    const char* at = row(source);
+
+    if (at == NULL || dest < 1 || dest > (int)head.nodes)
+    {
+        return INT_MAX;
+    } // end if (at == NULL || ...)
+
+    return readDist(at, dest);
+} // end distance(int, int)
+
+/**---------------------- path() ----------------------------------------------
+ * Reads the shortest path between two nodes by following the previous node
+ * of each back from dest. The whole path comes from the row for source.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @param nodes  Receives the nodes on the path, from source to dest; empty
+ *               if there is none.
+ * @pre None.
+ * @post None.
+ * @return The length of the path, or INT_MAX if there is none, either node
+ *         is not in the file, or the row is damaged so that the previous
+ *         nodes do not lead back to source.
+ */
+int PathFile::path(int source, int dest, vector<int>& nodes) const
+{
+    const char* at = row(source);
+    int         length = distance(source, dest);
+
+    nodes.clear();
+
+    if (length == INT_MAX)
+    {
+        return INT_MAX;
+    } // end if (length == INT_MAX)
+
+    for (int v = dest; v != 0; v = readPrev(at, v))
+    {
+        if (v < 0 || v > (int)head.nodes ||
+            (int)nodes.size() == (int)head.nodes)
+        {
+            nodes.clear();              // out of range, or around a loop
+            return INT_MAX;
+        } // end if (v < 0 || ...)
+
+        nodes.push_back(v);
+    } // end for (int v = dest)
+
+    if (nodes.back() != source)
+    {
+        nodes.clear();
+        return INT_MAX;
+    } // end if (nodes.back() != source)
+
+    reverse(nodes.begin(), nodes.end());
+    return length;
+} // end path(int, int, vector<int>&)
+
+/**---------------------- writeRows() -----------------------------------------
+ * Finds every row and appends it to a path file, a block at a time. Each
+ * worker takes every so many rows of a block, and keeps one set of scratch
+ * arrays for all the rows it finds in every block.
+ * @param output  The file, with the header written.
+ * @param header  The header of the file, for its widths.
+ * @param start  The first out-edge of each node.
+ * @param dest  The node each edge enters.
+ * @param cost  The cost of each edge.
+ * @param longest  No path is longer than this.
+ * @param pool  The workers to find rows with; NULL to find them here.
+ * @pre None.
+ * @post Every row is written, unless a distance did not fit its width.
+ * @return true if every distance fit; false, otherwise.
+ */
+bool PathFile::writeRows(ofstream& output, const PathFileHeader& header,
+                         const vector<int>& start, const vector<int>& dest,
+                         const vector<int>& cost, uint64_t longest,
+                         WorkPool* pool)
+{
+    int               nodes = header.nodes;
+    int               tasks = (pool == NULL ? 1 : pool->size());
+    int               perBlock;         // rows in a full block
+    vector<char>      block;            // rows found but not yet written
+    vector<RowSearch> search(tasks);    // scratch for each task
+    atomic<bool>      overflow(false);  // a distance did not fit
+    bool              check = (header.distWidth == 2 && longest >= 0xFFFF);
+
+    perBlock = (int)min<uint64_t>(nodes, max<uint64_t>(tasks,
+                   PATHBLOCK / header.rowBytes));
+    block.resize(perBlock * header.rowBytes);
+
+    for (int t = 0; t < tasks; ++t)
+    {
+        search[t].dist.assign(nodes + 1, INT_MAX);
+        search[t].prev.assign(nodes + 1, 0);
+    } // end for (int t = 0)
+
+    for (int first = 1; first <= nodes && output.good(); first += perBlock)
+    {
+        int last = min(nodes, first + perBlock - 1);
+
+        function<void(int)> findRows = [&](int task)
+        {
+            RowSearch& mine = search[task];
+
+            for (int source = first + task; source <= last && !overflow;
+                 source += tasks)
+            {
+                findRow(source, start, dest, cost, mine);
+
+                for (size_t k = 0; check && k < mine.touched.size(); ++k)
+                {
+                    if (mine.dist[mine.touched[k]] >= 0xFFFF)
+                    {
+                        overflow = true;
+                        return;
+                    } // end if (mine.dist[mine.touched[k]] >= 0xFFFF)
+                } // end for (size_t k = 0)
+
+                putRow(header, mine.dist, mine.prev,
+                       &block[(source - first) * header.rowBytes]);
+            } // end for (int source = first + task)
+        };
+
+        if (pool == NULL)
+        {
+            findRows(0);
+        }
+        else
+        {
+            pool->run(0, tasks - 1, findRows);
+        } // end if (pool == NULL)
+
+        if (overflow)
+        {
+            return false;
+        } // end if (overflow)
+
+        output.write(&block[0], (last - first + 1) * header.rowBytes);
+    } // end for (int first = 1)
+
+    return true;
+} // end writeRows(ofstream&, const PathFileHeader&, ...)
+
+/**---------------------- findRow() -------------------------------------------
+ * Finds the shortest paths from a single node with dijkstra(). The entries
+ * the last search in the scratch reached are reset first, so a search costs
+ * nothing for the nodes it never reaches.
+ * @param source  The node from which to find paths.
+ * @param start  The first out-edge of each node.
+ * @param dest  The node each edge enters.
+ * @param cost  The cost of each edge.
+ * @param search  The scratch, sized to the graph; receives the paths.
+ * @pre Entries of search not listed in search.touched are unset.
+ * @post search.dist and search.prev hold the shortest paths from source,
+ *       and search.touched lists the nodes reached.
+ */
+void PathFile::findRow(int source, const vector<int>& start,
+                       const vector<int>& dest, const vector<int>& cost,
+                       RowSearch& search)
+{
+    uint64_t settled = 0, shortened = 0;    // not reported
+
+    for (size_t k = 0; k < search.touched.size(); ++k)
+    {
+        search.dist[search.touched[k]] = INT_MAX;
+        search.prev[search.touched[k]] = 0;
+    } // end for (size_t k = 0)
+
+    search.touched.clear();
+    dijkstra(source, start.data(), dest.data(), cost.data(),
+             search.dist.data(), search.prev.data(), &search.touched,
+             [](int) { return true; }, settled, shortened);
+} // end findRow(int, const vector<int>&, const vector<int>&, ...)
+
+/**---------------------- rowBytesOf() ----------------------------------------
+ * Works out the length of each row from the node count and widths.
+ * @param header  The header of the file.
+ * @pre None.
+ * @post None.
+ * @return The bytes in each row, rounded up to a multiple of four.
+ */
+uint64_t PathFile::rowBytesOf(const PathFileHeader& header)
+{
+    return ((uint64_t)header.nodes * (header.distWidth + header.prevWidth) +
+            3) / 4 * 4;
+} // end rowBytesOf(const PathFileHeader&)
+
+/**---------------------- putRow() --------------------------------------------
+ * Stores the paths from one node as a row of the file.
+ * @param header  The header of the file, for its widths.
+ * @param dist  The length of the path to each node.
+ * @param prev  The node before each node on its path.
+ * @param row  Where to store the row; header.rowBytes long.
+ * @pre None.
+ * @post The row holds dist and then prev, each without element 0.
+ */
+void PathFile::putRow(const PathFileHeader& header, const vector<int>& dist,
+                      const vector<int>& prev, char* row)
+{
+    char* after = row + (size_t)header.nodes * header.distWidth;
+
+    for (uint32_t v = 1; v <= header.nodes; ++v)
+    {
+        putValue(row + (v - 1) * header.distWidth, header.distWidth, dist[v]);
+        putValue(after + (v - 1) * header.prevWidth, header.prevWidth,
+                 prev[v]);
+    } // end for (uint32_t v = 1)
+} // end putRow(const PathFileHeader&, const vector<int>&, ...)
+
+/**---------------------- row() -----------------------------------------------
+ * Finds the row for one source node in the mapping.
+ * @param source  The node whose row to find.
+ * @pre None.
+ * @post None.
+ * @return The first byte of the row, or NULL if source is not in the file.
+ */
+const char* PathFile::row(int source) const
+{
+    if (rows == NULL || source < 1 || source > (int)head.nodes)
+    {
+        return NULL;
+    } // end if (rows == NULL || ...)
+
+    return rows + (source - 1) * head.rowBytes;
+} // end row(int)
+
+/**---------------------- readDist() ------------------------------------------
+ * Reads one distance from a row.
+ * @param at  The first byte of the row.
+ * @param dest  The node whose distance to read.
+ * @pre dest is in the file.
+ * @post None.
+ * @return The distance, or INT_MAX if there is no path.
+ */
+int PathFile::readDist(const char* at, int dest) const
+{
+    return getValue(at + (size_t)(dest - 1) * head.distWidth,
+                    head.distWidth);
+} // end readDist(const char*, int)
+
+/**---------------------- readPrev() ------------------------------------------
+ * Reads the node before another on its path from a row.
+ * @param at  The first byte of the row.
+ * @param dest  The node whose previous node to read.
+ * @pre dest is in the file.
+ * @post None.
+ * @return The previous node; 0 if there is none.
+ */
+int PathFile::readPrev(const char* at, int dest) const
+{
+    return getValue(at + (size_t)head.nodes * head.distWidth +
+                    (size_t)(dest - 1) * head.prevWidth, head.prevWidth);
+} // end readPrev(const char*, int)
@@ -0,0 +1,108 @@
+/*
+ * @file    pathfile.h
+ * @brief   This class keeps the shortest paths between all pairs of nodes in
+ *          a file instead of in memory. Rows are found a block at a time,
+ *          one source per task, and written out as each block completes, so
+ *          finding them takes memory for one block and the edges rather than
+ *          for the whole table. The file is a fixed header followed by one
+ *          row per source node, in node order: the distance to every node,
+ *          then the node before it on the path. Distances and nodes are
+ *          narrowed to two bytes each when every value in the file fits.
+ *          Queries read the file through a memory mapping, so only the rows
+ *          asked for are paged in, and the system may drop them again as it
+ *          needs room.
+ */
+
+#ifndef _PATHFILE_H
+#define	_PATHFILE_H
+
+#include <climits>
+#include <fstream>
+#include <stdint.h>
+#include <vector>
+#include "workpool.h"
+
+using namespace std;
+const char     PATHMAGIC[8] = {'G', 'R', 'A', 'P', 'H', 'A', 'P', 'T'};
+const uint32_t PATHVERSION  = 1;            // bumped on any layout change
+const uint32_t PATHORDER    = 0x01020304;   // reads back swapped if the byte
+                                            //  order differs
+const size_t   PATHBLOCK    = 32 << 20;     // bytes of rows found before
+                                            //  they are written out
+
+struct PathFileHeader
+{
+    char     magic[8];          // PATHMAGIC
+    uint32_t version;           // PATHVERSION
+    uint32_t byteOrder;         // PATHORDER, as written
+    uint32_t headerBytes;       // size of this header; rows follow it
+    uint32_t nodes;             // number of nodes, and of rows
+    uint32_t distWidth;         // bytes in each distance, 2 or 4
+    uint32_t prevWidth;         // bytes in each previous node, 2 or 4
+    uint64_t rowBytes;          // bytes in each row, a multiple of four
+}; // end PathFileHeader
+
+class PathFile
+{
+public:
+
+    PathFile();
+
+    virtual ~PathFile();
+
+    static bool write(const char* name, int nodes, const vector<int>& start,
+                      const vector<int>& dest, const vector<int>& cost,
+                      bool narrow, int threads);
+
+    bool open(const char* name);
+
+    void close(void);
+
+    int nodes(void) const;
+
+    const PathFileHeader& header(void) const;
+
+    int distance(int source, int dest) const;
+
+    int path(int source, int dest, vector<int>& nodes) const;
+
+private:
+
+    PathFileHeader head;        // copy of the header, once checked
+    const char*    rows;        // first byte of the first row
+    void*          mapped;      // start of the mapping, if any
+    size_t         length;      // bytes mapped
+
+    PathFile(const PathFile&);                  // the mapping cannot be
+    PathFile& operator=(const PathFile&);       //  shared
+
+    struct RowSearch
+    {
+        vector<int> dist;           // distance to each node reached
+        vector<int> prev;           // node each was reached from
+        vector<int> touched;        // nodes reached, to reset next time
+    }; // end struct RowSearch
+
+    static bool writeRows(ofstream& output, const PathFileHeader& header,
+                          const vector<int>& start, const vector<int>& dest,
+                          const vector<int>& cost, uint64_t longest,
+                          WorkPool* pool);
+
+    static void findRow(int source, const vector<int>& start,
+                        const vector<int>& dest, const vector<int>& cost,
+                        RowSearch& search);
+
+    static void putRow(const PathFileHeader& header, const vector<int>& dist,
+                       const vector<int>& prev, char* row);
+
+    static uint64_t rowBytesOf(const PathFileHeader& header);
+
+    const char* row(int source) const;
+
+    int readDist(const char* at, int dest) const;
+
+    int readPrev(const char* at, int dest) const;
+
+}; // end class PathFile
+
+#endif	/* _PATHFILE_H */
@@ -0,0 +1,96 @@
+/*
+ * @file    pathstats.cpp
+ * @brief   This class holds counters and phase timers for the hot paths of
+ *          GraphM and GraphL. The counting is compiled in only when
+ *          GRAPH_STATS is defined; otherwise every counter reads zero.
+ */
+
+#include "pathstats.h"
+
+using namespace std;
+
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates a set of statistics with every counter and timer at zero.
+ * @pre None.
+ * @post Every counter and timer is zero.
+ */
+PathStats::PathStats()
+{
+    reset();
+} // end constructor
+
+/**---------------------- Copy Constructor ------------------------------------
+ * Creates a copy of another set of statistics, as read at one moment.
+ * @param other  The statistics to copy.
+ * @pre None.
+ * @post Every counter and timer matches other.
+ */
+PathStats::PathStats(const PathStats& other)
+{
+    *this = other;
+} // end copy constructor
+
+/**---------------------- operator= -------------------------------------------
+ * Copies another set of statistics, as read at one moment.
+ * @param other  The statistics to copy.
+ * @pre None.
+ * @post Every counter and timer matches other.
+ * @return This set of statistics.
+ */
+PathStats& PathStats::operator=(const PathStats& other)
+{
+    relaxations = other.relaxations.load();
+    settled = other.settled.load();
+    scanned = other.scanned.load();
+    recomputed = other.recomputed.load();
+    repaired = other.repaired.load();
+    invalidated = other.invalidated.load();
+    cacheHits = other.cacheHits.load();
+    dfsEdges = other.dfsEdges.load();
+    buildNs = other.buildNs.load();
+    pathNs = other.pathNs.load();
+    repairNs = other.repairNs.load();
+    displayNs = other.displayNs.load();
+    dfsNs = other.dfsNs.load();
+
+    return *this;
+} // end operator=
+
+/**---------------------- reset() ---------------------------------------------
+ * Sets every counter and timer back to zero.
+ * @pre None.
+ * @post Every counter and timer is zero.
+ */
+void PathStats::reset(void)
+{
+    relaxations = settled = scanned = 0;
+    recomputed = repaired = invalidated = cacheHits = 0;
+    dfsEdges = 0;
+    buildNs = pathNs = repairNs = displayNs = dfsNs = 0;
+} // end reset()
+
+/**---------------------- writeJson() -----------------------------------------
+ * Writes the statistics as a single JSON object on one line. The "enabled"
+ * member tells whether the counters were compiled in at all.
+ * @param output  The stream to which to write.
+ * @pre None.
+ * @post None.
+ */
+void PathStats::writeJson(ostream& output) const
+{
+    output << "{\"enabled\":" << (STATSENABLED ? "true" : "false")
+           << ",\"relaxations\":" << relaxations
+           << ",\"settled\":" << settled
+           << ",\"scanned\":" << scanned
+           << ",\"recomputed\":" << recomputed
+           << ",\"repaired\":" << repaired
+           << ",\"invalidated\":" << invalidated
+           << ",\"cacheHits\":" << cacheHits
+           << ",\"dfsEdges\":" << dfsEdges
+           << ",\"ns\":{\"build\":" << buildNs
+           << ",\"paths\":" << pathNs
+           << ",\"repair\":" << repairNs
+           << ",\"display\":" << displayNs
+           << ",\"dfs\":" << dfsNs << "}}";
+} // end writeJson(ostream&)
@@ -0,0 +1,106 @@
+/*
+ * @file    pathstats.h
+ * @brief   This class holds counters and phase timers for the hot paths of
+ *          GraphM and GraphL: edges relaxed, nodes settled, matrix cells
+ *          scanned, rows found from scratch or repaired, rows that were
+ *          already current, and edges followed by depth-first search. The
+ *          counting is compiled in only when GRAPH_STATS is defined; without
+ *          it the STATS_ macros below expand to nothing, so the hot loops are
+ *          exactly as they would be with no statistics at all, and every
+ *          counter reads zero. Counters may be bumped from many threads.
+ */
+
+#ifndef _PATHSTATS_H
+#define	_PATHSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <stdint.h>
+
+using namespace std;
+
+#ifdef GRAPH_STATS
+const bool STATSENABLED = true;
+#define STATS_LOCAL(name)           uint64_t name = 0
+#define STATS_ADD(counter, amount)  ((counter) += (amount))
+#define STATS_TIME(timer)           PhaseTimer phaseTimer(timer)
+#else
+const bool STATSENABLED = false;
+#define STATS_LOCAL(name)
+#define STATS_ADD(counter, amount)  ((void)0)
+#define STATS_TIME(timer)           ((void)0)
+#endif
+
+
+class PathStats
+{
+public:
+
+    atomic<uint64_t> relaxations;   // paths shortened through an edge
+    atomic<uint64_t> settled;       // nodes whose distance became final
+    atomic<uint64_t> scanned;       // matrix cells read by row scans
+    atomic<uint64_t> recomputed;    // rows of paths found from scratch
+    atomic<uint64_t> repaired;      // rows of paths repaired in place
+    atomic<uint64_t> invalidated;   // rows of paths discarded by edge changes
+    atomic<uint64_t> cacheHits;     // rows asked for that were current
+    atomic<uint64_t> dfsEdges;      // edges followed by depth-first search
+
+    atomic<uint64_t> buildNs;       // time spent in buildGraph()
+    atomic<uint64_t> pathNs;        //  in findShortestPath()
+    atomic<uint64_t> repairNs;      //  repairing paths after edge changes
+    atomic<uint64_t> displayNs;     //  in display() and displayAll(),
+                                    //  including any search they start
+    atomic<uint64_t> dfsNs;         //  in depth-first search
+
+    PathStats();
+
+    PathStats(const PathStats& other);
+
+    PathStats& operator=(const PathStats& other);
+
+    void reset(void);
+
+    void writeJson(ostream& output) const;
+
+}; // end class PathStats
+
+
+class PhaseTimer
+{
+public:
+
+    typedef chrono::steady_clock Clock;
+
+    /**------------------ Constructor -----------------------------------------
+     * Starts timing a phase.
+     * @param total  The timer of the phase, in nanoseconds.
+     * @pre None.
+     * @post The phase is being timed.
+     */
+    PhaseTimer(atomic<uint64_t>& total) : timer(total), start(Clock::now())
+    {
+    } // end Constructor
+
+    /**------------------ Destructor ------------------------------------------
+     * Adds the time since construction to the phase.
+     * @pre None.
+     * @post The phase timer includes this phase.
+     */
+    ~PhaseTimer()
+    {
+        timer += chrono::duration_cast<chrono::nanoseconds>(
+                     Clock::now() - start).count();
+    } // end Destructor
+
+private:
+
+    atomic<uint64_t>& timer;        // where the elapsed time goes
+    Clock::time_point start;        // when the phase began
+
+    PhaseTimer(const PhaseTimer&);
+    PhaseTimer& operator=(const PhaseTimer&);
+
+}; // end class PhaseTimer
+
+#endif	/* _PATHSTATS_H */
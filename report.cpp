@@ -0,0 +1,242 @@
+/*
+ * @file    report.cpp
+ * @brief   This class gathers formatted text in a large buffer and writes it
+ *          to a stream in big chunks, so that printing a report costs a few
+ *          writes instead of one formatted insertion per field and a flush
+ *          per line. Integers are formatted by hand. Padding works as the
+ *          stream width and alignment flags would, but the stream's own
+ *          flags are never touched.
+ */
+
+#include <cstring>
+#include "report.h"
+
+using namespace std;
+
+
+/**---------------------- Constructor -----------------------------------------
+ * Creates a writer for a stream.
+ * @param output  The stream to which the report is written.
+ * @pre output outlives this writer.
+ * @post The writer is empty.
+ */
+ReportWriter::ReportWriter(ostream& output) : sink(output)
+{
+    buffer.reserve(REPORTBUFFER + REPORTBUFFER / 4);
+} // end constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Writes out anything left in the buffer.
+ * @pre None.
+ * @post The whole report has been written and the stream flushed.
+ */
+ReportWriter::~ReportWriter()
+{
+    flush();
+} // end destructor
+
+/**---------------------- write() ---------------------------------------------
+ * Adds a single character.
+ * @param c  The character to add.
+ * @pre None.
+ * @post c is in the report.
+ */
+void ReportWriter::write(char c)
+{
+    buffer += c;
+    spill();
+} // end write(char)
+
+/**---------------------- write() ---------------------------------------------
+ * Adds a string.
+ * @param text  The string to add.
+ * @pre None.
+ * @post text is in the report.
+ */
+void ReportWriter::write(const char* text)
+{
+    buffer.append(text);
+    spill();
+} // end write(const char*)
+
+/**---------------------- write() ---------------------------------------------
+ * Adds a string.
+ * @param text  The string to add.
+ * @pre None.
+ * @post text is in the report.
+ */
+void ReportWriter::write(const string& text)
+{
+    buffer.append(text);
+    spill();
+} // end write(const string&)
+
+/**---------------------- write() ---------------------------------------------
+ * Adds a run of characters, such as an interned description.
+ * @param text  The characters to add; need not be terminated.
+ * @param length  The number of characters.
+ * @pre None.
+ * @post The characters are in the report.
+ */
+void ReportWriter::write(const char* text, size_t length)
+{
+    buffer.append(text, length);
+    spill();
+} // end write(const char*, size_t)
+
+/**---------------------- write() ---------------------------------------------
+ * Adds a node description, as operator<< would print it.
+ * @param item  The description to add.
+ * @pre None.
+ * @post item is in the report.
+ */
+void ReportWriter::write(const NodeData& item)
+{
+    writeLeft(item, 0);
+} // end write(const NodeData&)
+
+/**---------------------- writeLeft() -----------------------------------------
+ * Adds a string, padded with spaces on the right to a width.
+ * @param text  The string to add.
+ * @param width  The least number of characters to add.
+ * @pre None.
+ * @post text and its padding are in the report.
+ */
+void ReportWriter::writeLeft(const char* text, int width)
+{
+    int length = (int)strlen(text);
+
+    buffer.append(text, length);
+    pad(width - length);
+    spill();
+} // end writeLeft(const char*, int)
+
+/**---------------------- writeLeft() -----------------------------------------
+ * Adds a run of characters, padded with spaces on the right to a width.
+ * @param text  The characters to add; need not be terminated.
+ * @param length  The number of characters.
+ * @param width  The least number of characters to add.
+ * @pre None.
+ * @post The characters and their padding are in the report.
+ */
+void ReportWriter::writeLeft(const char* text, size_t length, int width)
+{
+    buffer.append(text, length);
+    pad(width - (int)length);
+    spill();
+} // end writeLeft(const char*, size_t, int)
+
+/**---------------------- writeLeft() -----------------------------------------
+ * Adds a node description, padded with spaces on the right to a width.
+ * @param item  The description to add.
+ * @param width  The least number of characters to add.
+ * @pre None.
+ * @post item and its padding are in the report.
+ */
+void ReportWriter::writeLeft(const NodeData& item, int width)
+{
+    size_t before = buffer.size();
+
+    scratch.str("");
+    scratch << item;
+    buffer.append(scratch.str());
+    pad(width - (int)(buffer.size() - before));
+    spill();
+} // end writeLeft(const NodeData&, int)
+
+/**---------------------- writeRight() ----------------------------------------
+ * Adds a string, padded with spaces on the left to a width.
+ * @param text  The string to add.
+ * @param width  The least number of characters to add.
+ * @pre None.
+ * @post text and its padding are in the report.
+ */
+void ReportWriter::writeRight(const char* text, int width)
+{
+    int length = (int)strlen(text);
+
+    pad(width - length);
+    buffer.append(text, length);
+    spill();
+} // end writeRight(const char*, int)
+
+/**---------------------- writeInt() ------------------------------------------
+ * Adds an integer in decimal.
+ * @param value  The integer to add.
+ * @pre None.
+ * @post value is in the report.
+ */
+void ReportWriter::writeInt(int value)
+{
+    writeInt(value, 0);
+} // end writeInt(int)
+
+/**---------------------- writeInt() ------------------------------------------
+ * Adds an integer in decimal, padded with spaces on the left to a width.
+ * @param value  The integer to add.
+ * @param width  The least number of characters to add.
+ * @pre None.
+ * @post value and its padding are in the report.
+ */
+void ReportWriter::writeInt(int value, int width)
+{
+    char         digits[12];                    // sign and ten digits
+    char*        start = digits + sizeof(digits);
+    unsigned int magnitude = (value < 0 ? 0U - (unsigned int)value
+                                        : (unsigned int)value);
+
+    do
+    {
+        *--start = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while(magnitude != 0);
+
+    if (value < 0)
+    {
+        *--start = '-';
+    } // end if (value < 0)
+
+    pad(width - (int)(digits + sizeof(digits) - start));
+    buffer.append(start, digits + sizeof(digits));
+    spill();
+} // end writeInt(int, int)
+
+/**---------------------- flush() ---------------------------------------------
+ * Writes out everything in the buffer.
+ * @pre None.
+ * @post The buffer is empty and the stream has been flushed.
+ */
+void ReportWriter::flush()
+{
+    sink.write(buffer.data(), buffer.size());
+    sink.flush();
+    buffer.clear();
+} // end flush()
+
+/**---------------------- pad() -----------------------------------------------
+ * Adds spaces.
+ * @param count  The number of spaces to add; none if not positive.
+ * @pre None.
+ * @post The spaces are in the report.
+ */
+void ReportWriter::pad(int count)
+{
+    if (count > 0)
+    {
+        buffer.append(count, ' ');
+    } // end if (count > 0)
+} // end pad(int)
+
+/**---------------------- spill() ---------------------------------------------
+ * Writes out the buffer once it is full, without flushing the stream.
+ * @pre None.
+ * @post The buffer holds less than REPORTBUFFER bytes.
+ */
+void ReportWriter::spill()
+{
+    if (buffer.size() >= REPORTBUFFER)
+    {
+        sink.write(buffer.data(), buffer.size());
+        buffer.clear();
+    } // end if (buffer.size() >= REPORTBUFFER)
+} // end spill()
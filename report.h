@@ -0,0 +1,67 @@
+/*
+ * @file    report.h
+ * @brief   This class gathers formatted text in a large buffer and writes it
+ *          to a stream in big chunks, so that printing a report costs a few
+ *          writes instead of one formatted insertion per field and a flush
+ *          per line. Integers are formatted by hand. Padding works as the
+ *          stream width and alignment flags would, but the stream's own
+ *          flags are never touched.
+ */
+
+#ifndef _REPORT_H
+#define	_REPORT_H
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include "nodedata.h"
+
+using namespace std;
+const size_t REPORTBUFFER = 1 << 16;    // bytes gathered before each write
+
+
+class ReportWriter
+{
+public:
+
+    ReportWriter(ostream& output);
+
+    virtual ~ReportWriter();
+
+    void write(char c);
+
+    void write(const char* text);
+
+    void write(const string& text);
+
+    void write(const char* text, size_t length);
+
+    void write(const NodeData& item);
+
+    void writeLeft(const char* text, int width);
+
+    void writeLeft(const char* text, size_t length, int width);
+
+    void writeLeft(const NodeData& item, int width);
+
+    void writeRight(const char* text, int width);
+
+    void writeInt(int value);
+
+    void writeInt(int value, int width);
+
+    void flush(void);
+
+private:
+
+    ostream&      sink;         // stream the report goes to
+    string        buffer;       // text not yet written
+    ostringstream scratch;      // renders node descriptions
+
+    void pad(int count);
+
+    void spill(void);
+
+}; // end class ReportWriter
+
+#endif	/* _REPORT_H */
@@ -0,0 +1,331 @@
+/*
+ * @file    sharedgraph.cpp
+ * @brief   This class lets many threads query the shortest paths of a graph
+ *          while one thread at a time changes its edges. Readers query an
+ *          immutable version of the graph, with every path already found,
+ *          and never take a lock. Writers stage edge changes and publish
+ *          them together, replacing the current version with one atomic
+ *          store. A replaced version is freed by epoch-based reclamation
+ *          once no reader can still be using it.
+ */
+
+#include <stdexcept>
+#include "sharedgraph.h"
+
+using namespace std;
+
+
+/**---------------------- Constructor -----------------------------------------
+ * Creates a shared graph with no nodes and a fixed number of reader slots.
+ * @param readers  The most threads that may query at once.
+ * @pre readers is positive.
+ * @post The current version is an empty graph, numbered 0.
+ */
+SharedGraph::SharedGraph(int readers) : current(new Version()), epoch(1),
+                                        slots(readers)
+{
+    current.load()->number = 0;
+} // end constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Frees every version.
+ * @pre No reader is querying.
+ * @post All memory is freed.
+ */
+SharedGraph::~SharedGraph()
+{
+    for (int i = 0; i < (int)retired.size(); ++i)
+    {
+        delete retired[i].first;
+    } // end for (int i = 0)
+
+    delete current.load();
+} // end destructor
+
+/**---------------------- load() ----------------------------------------------
+ * Publishes a copy of a graph, with all of its shortest paths found, as the
+ * new current version. Staged changes are dropped.
+ * @param graph  The graph to publish.
+ * @pre None.
+ * @post Queries that start from now on see graph.
+ */
+void SharedGraph::load(const GraphM& graph)
+{
+    lock_guard<mutex> hold(writer);
+    Version* next = new Version();
+
+    next->graph = graph;
+    next->graph.findShortestPath();
+    next->number = current.load()->number + 1;
+    pending.clear();
+    replace(next);
+} // end load(const GraphM&)
+
+/**---------------------- join() ----------------------------------------------
+ * Claims a reader slot for the calling thread.
+ * @pre None.
+ * @post The slot, if any, is the caller's until it calls leave().
+ * @return The slot to pass to queries; -1 if every slot is taken, which
+ *         every query and leave() reject.
+ */
+int SharedGraph::join(void)
+{
+    for (int i = 0; i < (int)slots.size(); ++i)
+    {
+        bool idle = false;
+
+        if (slots[i].taken.compare_exchange_strong(idle, true))
+        {
+            return i;
+        } // end if (slots[i].taken.compare_exchange_strong(idle, true))
+    } // end for (int i = 0)
+
+    return -1;
+} // end join()
+
+/**---------------------- leave() ---------------------------------------------
+ * Gives back a reader slot.
+ * @param reader  The slot claimed by join().
+ * @pre The caller is not querying with the slot.
+ * @post Another thread may claim the slot. Throws out_of_range if reader is
+ *       not a claimed slot.
+ */
+void SharedGraph::leave(int reader)
+{
+    checkReader(reader);
+    slots[reader].taken = false;
+} // end leave(int)
+
+/**---------------------- distance() ------------------------------------------
+ * Finds the length of the shortest path between two nodes in the current
+ * version, without taking a lock.
+ * @param reader  The caller's slot.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @pre The caller holds the slot.
+ * @post None.
+ * @return The length of the path, or INT_MAX if there is none or either node
+ *         is not in the graph.
+ */
+int SharedGraph::distance(int reader, int source, int dest) const
+{
+    int length = enter(reader)->graph.readDistance(source, dest);
+
+    exit(reader);
+    return length;
+} // end distance(int, int, int)
+
+/**---------------------- path() ----------------------------------------------
+ * Lists the nodes on the shortest path between two nodes in the current
+ * version, without taking a lock. The length and the nodes always come from
+ * the same version.
+ * @param reader  The caller's slot.
+ * @param source  The node from which to start the path.
+ * @param dest  The node at which to end the path.
+ * @param nodes  Receives the nodes on the path, from source to dest; empty
+ *               if there is none.
+ * @pre The caller holds the slot.
+ * @post None.
+ * @return The length of the path, or INT_MAX if there is none or either node
+ *         is not in the graph.
+ */
+int SharedGraph::path(int reader, int source, int dest,
+                      vector<int>& nodes) const
+{
+    int length = enter(reader)->graph.readPath(source, dest, nodes);
+
+    exit(reader);
+    return length;
+} // end path(int, int, int, vector<int>&)
+
+/**---------------------- version() -------------------------------------------
+ * Reports which version queries currently see.
+ * @param reader  The caller's slot.
+ * @pre The caller holds the slot.
+ * @post None.
+ * @return The number of versions published before the current one.
+ */
+uint64_t SharedGraph::version(int reader) const
+{
+    uint64_t number = enter(reader)->number;
+
+    exit(reader);
+    return number;
+} // end version(int)
+
+/**---------------------- insertEdge() ----------------------------------------
+ * Stages the insertion of an edge, or a new cost for one. Queries do not see
+ * it until publish().
+ * @param source  The node from which to start the edge.
+ * @param dest  The adjacent node at which to end the edge.
+ * @param cost  The cost of the edge.
+ * @pre None.
+ * @post The change is staged. Invalid changes are ignored when published.
+ */
+void SharedGraph::insertEdge(int source, int dest, int cost)
+{
+    lock_guard<mutex> hold(writer);
+    Edit              edit = { source, dest, cost };
+
+    if (cost > 0)           // 0 would read as a removal
+    {
+        pending.push_back(edit);
+    } // end if (cost > 0)
+} // end insertEdge(int, int, int)
+
+/**---------------------- removeEdge() ----------------------------------------
+ * Stages the removal of an edge. Queries do not see it until publish().
+ * @param source  The node from which the edge starts.
+ * @param dest  The adjacent node at which the edge ends.
+ * @pre None.
+ * @post The change is staged. Invalid changes are ignored when published.
+ */
+void SharedGraph::removeEdge(int source, int dest)
+{
+    lock_guard<mutex> hold(writer);
+    Edit              edit = { source, dest, 0 };
+
+    pending.push_back(edit);
+} // end removeEdge(int, int)
+
+/**---------------------- publish() -------------------------------------------
+ * Applies every staged change to a copy of the current version, brings its
+ * paths up to date, and makes it current. The paths are repaired in place
+ * where the graph allows, so a small batch costs far less than finding
+ * every path again. Queries already running finish on the version they
+ * started with; versions no reader can still see are freed.
+ * @pre None.
+ * @post No change is staged, and queries that start from now on see every
+ *       change staged before this call.
+ * @return The number of the current version.
+ */
+uint64_t SharedGraph::publish(void)
+{
+    lock_guard<mutex> hold(writer);
+    const Version* last = current.load();
+    Version*       next;
+
+    if (pending.empty())
+    {
+        reclaim();
+        return last->number;
+    } // end if (pending.empty())
+
+    next = new Version();
+    next->graph = last->graph;          // readers only read it, so copying
+    next->number = last->number + 1;    //  it races with nothing
+
+    for (int i = 0; i < (int)pending.size(); ++i)
+    {
+        if (pending[i].cost > 0)
+        {
+            next->graph.insertEdge(pending[i].source, pending[i].dest,
+                                   pending[i].cost);
+        }
+        else
+        {
+            next->graph.removeEdge(pending[i].source, pending[i].dest);
+        } // end if (pending[i].cost > 0)
+    } // end for (int i = 0)
+
+    next->graph.findShortestPath();     // rows the repair left stale
+    pending.clear();
+    replace(next);
+    return next->number;
+} // end publish()
+
+/**---------------------- checkReader() ---------------------------------------
+ * Checks that a reader slot exists and is claimed, so a failed join() is
+ * caught before the slot is used.
+ * @param reader  The caller's slot.
+ * @pre None.
+ * @post Throws out_of_range if reader is not a claimed slot.
+ */
+void SharedGraph::checkReader(int reader) const
+{
+    if (reader < 0 || reader >= (int)slots.size() ||
+        !slots[reader].taken.load(memory_order_relaxed))
+    {
+        throw out_of_range("SharedGraph: reader slot not claimed");
+    } // end if (reader < 0 || ...)
+} // end checkReader(int)
+
+/**---------------------- enter() ---------------------------------------------
+ * Starts a query: announces the epoch the reader entered in, then takes the
+ * current version. A version replaced after the announcement is kept until
+ * the reader exits.
+ * @param reader  The caller's slot.
+ * @pre The caller holds the slot and is not in a query.
+ * @post The reader is in a query. Throws out_of_range if reader is not a
+ *       claimed slot.
+ * @return The version to query.
+ */
+const SharedGraph::Version* SharedGraph::enter(int reader) const
+{
+    checkReader(reader);
+    slots[reader].epoch.store(epoch.load());
+    return current.load();
+} // end enter(int)
+
+/**---------------------- exit() ----------------------------------------------
+ * Ends a query.
+ * @param reader  The caller's slot.
+ * @pre The reader is in a query.
+ * @post The reader no longer holds any version.
+ */
+void SharedGraph::exit(int reader) const
+{
+    slots[reader].epoch.store(0);
+} // end exit(int)
+
+/**---------------------- replace() -------------------------------------------
+ * Makes a version current and retires the one it replaces. The epoch is
+ * advanced after the swap, so a reader that announces the new epoch can only
+ * take the new version; the old one waits until every reader is idle or has
+ * announced an epoch at least that new.
+ * @param next  The version to make current.
+ * @pre The caller holds the writer lock.
+ * @post next is current. Versions no reader can see are freed.
+ */
+void SharedGraph::replace(Version* next)
+{
+    Version* old = current.exchange(next);
+
+    retired.push_back(make_pair(old, epoch.fetch_add(1) + 1));
+    reclaim();
+} // end replace(Version*)
+
+/**---------------------- reclaim() -------------------------------------------
+ * Frees every retired version that no reader can still be using.
+ * @pre The caller holds the writer lock.
+ * @post Only retired versions some reader might hold are kept.
+ */
+void SharedGraph::reclaim(void)
+{
+    uint64_t oldest = UINT64_MAX;       // oldest epoch a reader is in
+    int      kept = 0;
+
+    for (int i = 0; i < (int)slots.size(); ++i)
+    {
+        uint64_t entered = slots[i].epoch.load();
+
+        if (entered != 0 && entered < oldest)
+        {
+            oldest = entered;
+        } // end if (entered != 0 && entered < oldest)
+    } // end for (int i = 0)
+
+    for (int i = 0; i < (int)retired.size(); ++i)
+    {
+        if (retired[i].second <= oldest)
+        {
+            delete retired[i].first;
+        }
+        else
+        {
+            retired[kept++] = retired[i];
+        } // end if (retired[i].second <= oldest)
+    } // end for (int i = 0)
+
+    retired.resize(kept);
+} // end reclaim()
@@ -0,0 +1,102 @@
+/*
+ * @file    sharedgraph.h
+ * @brief   This class lets many threads query the shortest paths of a graph
+ *          while one thread at a time changes its edges. Readers query an
+ *          immutable version of the graph, with every path already found,
+ *          and never take a lock. Writers stage edge changes and publish
+ *          them together: a copy of the current version has the changes
+ *          applied and its paths repaired, and then replaces the current
+ *          version with one atomic store. A replaced version is freed by
+ *          epoch-based reclamation once no reader can still be using it.
+ *          Each reader thread claims one of a fixed number of reader slots
+ *          and passes it to every query; a slot not claimed throws
+ *          out_of_range.
+ */
+
+#ifndef _SHAREDGRAPH_H
+#define	_SHAREDGRAPH_H
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+#include "aligned.h"
+#include "graphm.h"
+
+using namespace std;
+
+
+class SharedGraph
+{
+public:
+
+    SharedGraph(int readers);
+
+    virtual ~SharedGraph();
+
+    void load(const GraphM& graph);
+
+    int join(void);
+
+    void leave(int reader);
+
+    int distance(int reader, int source, int dest) const;
+
+    int path(int reader, int source, int dest, vector<int>& nodes) const;
+
+    uint64_t version(int reader) const;
+
+    void insertEdge(int source, int dest, int cost);
+
+    void removeEdge(int source, int dest);
+
+    uint64_t publish(void);
+
+private:
+
+    struct Version
+    {
+        GraphM   graph;         // every row of the path matrix is current
+        uint64_t number;        // count of versions published before it
+    }; // end struct Version
+
+    struct Edit
+    {
+        int source;             // node from which the edge starts
+        int dest;               // node at which the edge ends
+        int cost;               // new cost; 0 to remove the edge
+    }; // end struct Edit
+
+    struct ReaderSlot           // one cache line per reader
+    {
+        atomic<uint64_t> epoch; // epoch entered by the reader; 0 if idle
+        atomic<bool>     taken; // claimed by a reader thread
+        char pad[ALIGNMENT - sizeof(atomic<uint64_t>) - sizeof(atomic<bool>)];
+
+        ReaderSlot() : epoch(0), taken(false) { }
+    }; // end struct ReaderSlot
+
+    atomic<Version*>   current;         // version readers query
+    atomic<uint64_t>   epoch;           // advanced on every publication
+    mutable vector<ReaderSlot, AlignedAllocator<ReaderSlot> > slots;
+    mutex              writer;          // guards everything below
+    vector<Edit>       pending;         // changes not yet published
+    vector<pair<Version*, uint64_t> > retired;  // replaced versions and the
+                                                //  epoch that frees them
+
+    void checkReader(int reader) const;
+
+    const Version* enter(int reader) const;
+
+    void exit(int reader) const;
+
+    void replace(Version* next);
+
+    void reclaim(void);
+
+    SharedGraph(const SharedGraph&);                // versions cannot
+    SharedGraph& operator=(const SharedGraph&);     //  be shared
+
+}; // end class SharedGraph
+
+#endif	/* _SHAREDGRAPH_H */
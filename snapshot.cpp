@@ -0,0 +1,281 @@
+/*
+ * @file    snapshot.cpp
+ * @brief   These classes write and read graph snapshots: binary files that
+ *          hold a whole graph, and optionally its shortest paths, so it can
+ *          be reloaded without parsing text or finding paths again. A file
+ *          is a fixed header followed by a body of sections. Every section is
+ *          padded to a multiple of four bytes. The header records the format
+ *          version, byte order, node count and cost width, and carries a
+ *          checksum of itself and of the body. Snapshots are read through a
+ *          memory mapping where the file allows it.
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "snapshot.h"
+
+using namespace std;
+
+
+/**---------------------- snapshotChecksum() ----------------------------------
+ * Folds data into a running checksum, four bytes at a time, in the manner of
+ * FNV-1a. A trailing partial word is padded with zeros, as it is in a file.
+ * @param sum  The checksum of everything before data; 0 to start.
+ * @param data  The bytes to add.
+ * @param bytes  The number of bytes to add.
+ * @pre None.
+ * @post None.
+ * @return The checksum including data.
+ */
+uint64_t snapshotChecksum(uint64_t sum, const void* data, size_t bytes)
+{
+    const unsigned char* scan = static_cast<const unsigned char*>(data);
+    uint32_t             word;
+
+    for (; bytes >= 4; bytes -= 4, scan += 4)
+    {
+        memcpy(&word, scan, 4);
+        sum = (sum ^ word) * 0x100000001B3ULL;
+    } // end for (; bytes >= 4)
+
+    if (bytes > 0)          // pad the last word
+    {
+        word = 0;
+        memcpy(&word, scan, bytes);
+        sum = (sum ^ word) * 0x100000001B3ULL;
+    } // end if (bytes > 0)
+
+    return sum;
+} // end snapshotChecksum(uint64_t, const void*, size_t)
+
+/**---------------------- SnapshotWriter Constructor --------------------------
+ * Creates a snapshot file and leaves room for its header.
+ * @param name  The path of the file to write.
+ * @pre None.
+ * @post The file is ready for the body to be written, or write() and
+ *       finish() will fail.
+ */
+SnapshotWriter::SnapshotWriter(const char* name) :
+    output(name, ios::out | ios::binary | ios::trunc), sum(0), written(0)
+{
+    SnapshotHeader blank;
+
+    memset(&blank, 0, sizeof(blank));
+    output.write(reinterpret_cast<const char*>(&blank), sizeof(blank));
+} // end constructor
+
+/**---------------------- SnapshotWriter Destructor ---------------------------
+ * Closes the file.
+ * @pre None.
+ * @post The file is closed. It is not a valid snapshot unless finish()
+ *       succeeded.
+ */
+SnapshotWriter::~SnapshotWriter()
+{
+} // end destructor
+
+/**---------------------- write() ---------------------------------------------
+ * Appends a section, or part of one, to the body.
+ * @param data  The bytes to write.
+ * @param bytes  The number of bytes to write.
+ * @pre None.
+ * @post The bytes are written and padded with zeros to a multiple of four.
+ * @return true if the file is still good; false, otherwise.
+ */
+bool SnapshotWriter::write(const void* data, size_t bytes)
+{
+    static const char zeros[4] = {0, 0, 0, 0};
+    size_t            pad = (4 - bytes % 4) % 4;
+
+    output.write(static_cast<const char*>(data), bytes);
+    output.write(zeros, pad);
+    sum = snapshotChecksum(sum, data, bytes);
+    written += bytes + pad;
+
+    return output.good();
+} // end write(const void*, size_t)
+
+/**---------------------- finish() --------------------------------------------
+ * Completes the header with the fields this writer tracks and writes it over
+ * the space left at the start of the file.
+ * @param header  The header, with the fields that describe the graph set.
+ * @pre The whole body has been written.
+ * @post The header in the file is complete, and so is the snapshot.
+ * @return true if the file was written in full; false, otherwise.
+ */
+bool SnapshotWriter::finish(SnapshotHeader& header)
+{
+    memcpy(header.magic, SNAPMAGIC, sizeof(header.magic));
+    header.version = SNAPVERSION;
+    header.byteOrder = SNAPORDER;
+    header.headerBytes = sizeof(header);
+    header.bodyBytes = written;
+    header.bodyChecksum = sum;
+    header.headerChecksum = 0;
+    header.headerChecksum = snapshotChecksum(0, &header, sizeof(header));
+
+    output.seekp(0);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.flush();
+
+    return output.good();
+} // end finish(SnapshotHeader&)
+
+/**---------------------- SnapshotReader Constructor --------------------------
+ * Opens a snapshot, maps it into memory and checks it. A file that cannot
+ * be mapped is read into memory in full.
+ * @param name  The path of the file to read.
+ * @pre None.
+ * @post valid() reports whether the file is a complete snapshot this version
+ *       can read. If so, take() returns the body from its start.
+ */
+SnapshotReader::SnapshotReader(const char* name) : next(NULL), end(NULL),
+    mapped(NULL), length(0), checked(false)
+{
+    int         fd = open(name, O_RDONLY);
+    struct stat info;
+
+    memset(&head, 0, sizeof(head));
+
+    if (fd < 0)             // file does not exist or cannot be read
+    {
+        return;
+    } // end if (fd < 0)
+
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        length = info.st_size;
+        mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapped == MAP_FAILED)
+        {
+            mapped = NULL;
+            length = 0;
+        }
+        else
+        {
+            madvise(mapped, length, MADV_SEQUENTIAL);
+            checked = check(static_cast<const char*>(mapped), length);
+        } // end if (mapped == MAP_FAILED)
+    } // end if (fstat(fd, &info) == 0 && ...)
+
+    if (mapped == NULL)     // empty, or not a regular file
+    {
+        char    buffer[65536];
+        ssize_t got;
+
+        while((got = read(fd, buffer, sizeof(buffer))) > 0)
+        {
+            copied.insert(copied.end(), buffer, buffer + got);
+        } // end while((got = read(...)) > 0)
+
+        checked = (!copied.empty() && check(&copied[0], copied.size()));
+    } // end if (mapped == NULL)
+
+    close(fd);
+} // end constructor
+
+/**---------------------- SnapshotReader Destructor ---------------------------
+ * Unmaps the file.
+ * @pre None.
+ * @post All memory is freed.
+ */
+SnapshotReader::~SnapshotReader()
+{
+    if (mapped != NULL)
+    {
+        munmap(mapped, length);
+    } // end if (mapped != NULL)
+} // end destructor
+
+/**---------------------- valid() ---------------------------------------------
+ * Reports whether the file is a complete, undamaged snapshot that this
+ * version can read.
+ * @pre None.
+ * @post None.
+ * @return true if the header and body check out; false, otherwise.
+ */
+bool SnapshotReader::valid() const
+{
+    return checked;
+} // end valid()
+
+/**---------------------- header() --------------------------------------------
+ * Gives the header of the snapshot.
+ * @pre valid() is true.
+ * @post None.
+ * @return The header.
+ */
+const SnapshotHeader& SnapshotReader::header() const
+{
+    return head;
+} // end header()
+
+/**---------------------- take() ----------------------------------------------
+ * Reads the next section, or part of one, of the body in place.
+ * @param bytes  The number of bytes to read.
+ * @pre None.
+ * @post The bytes and their padding are consumed.
+ * @return A pointer to the bytes, valid while this reader exists, or NULL if
+ *         the body is too short or the snapshot is not valid.
+ */
+const void* SnapshotReader::take(size_t bytes)
+{
+    const char* start = next;
+    size_t      padded = bytes + (4 - bytes % 4) % 4;
+
+    if (!checked || padded > (size_t)(end - next))
+    {
+        return NULL;
+    } // end if (!checked || ...)
+
+    next += padded;
+
+    return start;
+} // end take(size_t)
+
+/**---------------------- check() ---------------------------------------------
+ * Checks the header and body of a snapshot held in memory.
+ * @param file  The whole file.
+ * @param bytes  The length of the file.
+ * @pre None.
+ * @post If the snapshot checks out, the header is copied and the body is
+ *       ready to be taken.
+ * @return true if the snapshot is complete, undamaged and of this version;
+ *         false, otherwise.
+ */
+bool SnapshotReader::check(const char* file, size_t bytes)
+{
+    SnapshotHeader found;
+    uint64_t       sum;
+
+    if (bytes < sizeof(found))
+    {
+        return false;
+    } // end if (bytes < sizeof(found))
+
+    memcpy(&found, file, sizeof(found));
+    sum = found.headerChecksum;
+    found.headerChecksum = 0;
+
+    if (memcmp(found.magic, SNAPMAGIC, sizeof(found.magic)) != 0 ||
+        found.version != SNAPVERSION || found.byteOrder != SNAPORDER ||
+        found.headerBytes != sizeof(found) ||
+        snapshotChecksum(0, &found, sizeof(found)) != sum ||
+        found.bodyBytes != bytes - sizeof(found) ||
+        snapshotChecksum(0, file + sizeof(found), found.bodyBytes) !=
+            found.bodyChecksum)
+    {
+        return false;
+    } // end if (memcmp(found.magic, SNAPMAGIC, ...) != 0 || ...)
+
+    found.headerChecksum = sum;
+    head = found;
+    next = file + sizeof(found);
+    end = next + found.bodyBytes;
+
+    return true;
+} // end check(const char*, size_t)
@@ -0,0 +1,96 @@
+/*
+ * @file    snapshot.h
+ * @brief   These classes write and read graph snapshots: binary files that
+ *          hold a whole graph, and optionally its shortest paths, so it can
+ *          be reloaded without parsing text or finding paths again. A file
+ *          is a fixed header followed by a body of sections. Every section is
+ *          padded to a multiple of four bytes. The header records the format
+ *          version, byte order, node count and cost width, and carries a
+ *          checksum of itself and of the body. Snapshots are read through a
+ *          memory mapping where the file allows it.
+ */
+
+#ifndef _SNAPSHOT_H
+#define	_SNAPSHOT_H
+
+#include <fstream>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+const char     SNAPMAGIC[8] = {'G', 'R', 'A', 'P', 'H', 'S', 'N', 'P'};
+const uint32_t SNAPVERSION  = 1;            // bumped on any layout change
+const uint32_t SNAPORDER    = 0x01020304;   // reads back swapped if the byte
+                                            //  order differs
+const uint32_t SNAPPATHS    = 1;            // flag: path matrix is included
+
+struct SnapshotHeader
+{
+    char     magic[8];          // SNAPMAGIC
+    uint32_t version;           // SNAPVERSION
+    uint32_t byteOrder;         // SNAPORDER, as written
+    uint32_t headerBytes;       // size of this header
+    uint32_t costWidth;         // bytes in each cost and distance
+    uint32_t nodes;             // number of nodes in the graph
+    uint32_t flags;             // SNAPPATHS, if set
+    uint64_t edges;             // number of edges in the graph
+    uint64_t textBytes;         // total length of all node descriptions
+    uint64_t bodyBytes;         // bytes following this header
+    uint64_t bodyChecksum;      // snapshotChecksum() of the body
+    uint64_t headerChecksum;    // of this header, with this field zero
+}; // end SnapshotHeader
+
+uint64_t snapshotChecksum(uint64_t sum, const void* data, size_t bytes);
+
+class SnapshotWriter
+{
+public:
+
+    SnapshotWriter(const char* name);
+
+    virtual ~SnapshotWriter();
+
+    bool write(const void* data, size_t bytes);
+
+    bool finish(SnapshotHeader& header);
+
+private:
+
+    ofstream output;            // the snapshot file
+    uint64_t sum;               // checksum of the body so far
+    uint64_t written;           // bytes of body so far
+
+}; // end class SnapshotWriter
+
+class SnapshotReader
+{
+public:
+
+    SnapshotReader(const char* name);
+
+    virtual ~SnapshotReader();
+
+    bool valid(void) const;
+
+    const SnapshotHeader& header(void) const;
+
+    const void* take(size_t bytes);
+
+private:
+
+    SnapshotHeader head;        // copy of the header, once checked
+    const char*    next;        // next unread byte of the body
+    const char*    end;         // one past the last byte of the body
+    void*          mapped;      // start of the mapping, if any
+    size_t         length;      // bytes mapped
+    vector<char>   copied;      // file contents, if they could not be mapped
+    bool           checked;     // header and body checksums match
+
+    SnapshotReader(const SnapshotReader&);      // the mapping cannot be
+    SnapshotReader& operator=(const SnapshotReader&);   //  shared
+
+    bool check(const char* file, size_t bytes);
+
+}; // end class SnapshotReader
+
+#endif	/* _SNAPSHOT_H */
@@ -0,0 +1,154 @@
+/*
+ * @file    workpool.cpp
+ * @brief   This class spreads a range of independent tasks over a group of
+ *          worker threads. Each worker starts with an even share of the range
+ *          in its own queue and, once that queue is empty, steals tasks from
+ *          the back of the other queues. Tasks that take very different
+ *          amounts of time therefore still keep every worker busy.
+ */
+
+#include <thread>
+#include "workpool.h"
+
+using namespace std;
+
+
+/**---------------------- Constructor -----------------------------------------
+ * Creates a pool with a fixed number of workers.
+ * @param threads  The number of workers to use. A value less than one uses
+ *                 one worker per hardware thread.
+ * @pre None.
+ * @post The pool has at least one worker and no tasks.
+ */
+WorkPool::WorkPool(int threads) : workers(threads)
+{
+    if (workers < 1)
+    {
+        workers = thread::hardware_concurrency();
+    } // end if (workers < 1)
+
+    if (workers < 1)    // hardware could not be queried
+    {
+        workers = 1;
+    } // end if (workers < 1)
+
+    for (int i = 0; i < workers; ++i)
+    {
+        queues.push_back(new TaskQueue);
+    } // end for (int i = 0)
+} // end Constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Frees the task queues.
+ * @pre No call to run() is in progress.
+ * @post All memory is freed.
+ */
+WorkPool::~WorkPool()
+{
+    for (int i = 0; i < workers; ++i)
+    {
+        delete queues[i];
+    } // end for (int i = 0)
+} // end destructor
+
+/**---------------------- size() ----------------------------------------------
+ * Reports the number of workers in this pool.
+ * @pre None.
+ * @post None.
+ * @return The number of threads, including the caller, that run tasks.
+ */
+int WorkPool::size(void) const
+{
+    return workers;
+} // end size()
+
+/**---------------------- run() -----------------------------------------------
+ * Invokes a task once for every integer in a range and waits for all of them
+ * to finish. The calling thread acts as one of the workers. Tasks may run in
+ * any order and at the same time, so each must touch only its own data.
+ * @param first  The first integer of the range.
+ * @param last  The last integer of the range, inclusive.
+ * @param task  The function to invoke for each integer.
+ * @pre No other call to run() is in progress on this pool.
+ * @post task has returned for every integer from first to last.
+ */
+void WorkPool::run(int first, int last, const function<void(int)>& task)
+{
+    int count = last - first + 1;       // number of tasks to spread
+    vector<thread> helpers;
+
+    for (int i = 0; i < workers; ++i)   // give each worker an even share
+    {
+        for (int item = first + (long long)count * i / workers;
+             item < first + (long long)count * (i + 1) / workers; ++item)
+        {
+            queues[i]->tasks.push_back(item);
+        } // end for (int item = ...)
+    } // end for (int i = 0)
+
+    for (int i = 1; i < workers && i < count; ++i)
+    {
+        helpers.push_back(thread(&WorkPool::work, this, i, cref(task)));
+    } // end for (int i = 1)
+
+    work(0, task);
+
+    for (int i = 0; i < (int)helpers.size(); ++i)
+    {
+        helpers[i].join();
+    } // end for (int i = 0)
+} // end run(int, int, const function<void(int)>&)
+
+/**---------------------- work() ----------------------------------------------
+ * Runs tasks until none remain in any queue.
+ * @param id  The worker running the tasks.
+ * @param task  The function to invoke for each task.
+ * @pre The queues hold the tasks of the current run.
+ * @post Every queue is empty.
+ */
+void WorkPool::work(int id, const function<void(int)>& task)
+{
+    int item;
+
+    while(nextTask(id, item))
+    {
+        task(item);
+    } // end while(nextTask(id, item))
+} // end work(int, const function<void(int)>&)
+
+/**---------------------- nextTask() ------------------------------------------
+ * Takes the next task for a worker. The worker's own queue is served from the
+ * front; when it is empty, a task is stolen from the back of the next queue
+ * that has one.
+ * @param id  The worker that will run the task.
+ * @param item  Receives the task taken.
+ * @pre None.
+ * @post If a task was taken, it has been removed from its queue.
+ * @return true if a task was taken; false, if every queue is empty.
+ */
+bool WorkPool::nextTask(int id, int& item)
+{
+    for (int i = 0; i < workers; ++i)
+    {
+        TaskQueue* queue = queues[(id + i) % workers];
+        lock_guard<mutex> guard(queue->lock);
+
+        if (!queue->tasks.empty())
+        {
+            if (i == 0)     // own queue
+            {
+                item = queue->tasks.front();
+                queue->tasks.pop_front();
+            }
+            else            // steal from a busier worker
+            {
+                item = queue->tasks.back();
+                queue->tasks.pop_back();
+            } // end if (i == 0)
+
+            return true;
+        } // end if (!queue->tasks.empty())
+    } // end for (int i = 0)
+
+    return false;
+} // end nextTask(int, int&)
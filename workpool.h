@@ -0,0 +1,50 @@
+/*
+ * @file    workpool.h
+ * @brief   This class spreads a range of independent tasks over a group of
+ *          worker threads. Each worker starts with an even share of the range
+ *          in its own queue and, once that queue is empty, steals tasks from
+ *          the back of the other queues. Tasks that take very different
+ *          amounts of time therefore still keep every worker busy.
+ */
+
+#ifndef _WORKPOOL_H
+#define	_WORKPOOL_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+
+class WorkPool
+{
+public:
+
+    WorkPool(int threads);
+
+    virtual ~WorkPool();
+
+    int size(void) const;
+
+    void run(int first, int last, const function<void(int)>& task);
+
+private:
+
+    struct TaskQueue
+    {
+        mutex      lock;        // guards tasks against thieves
+        deque<int> tasks;       // tasks not yet started
+    }; // end struct TaskQueue
+
+    int                 workers;    // number of threads, including caller
+    vector<TaskQueue*>  queues;     // one queue per worker
+
+    void work(int id, const function<void(int)>& task);
+
+    bool nextTask(int id, int& item);
+
+}; // end class WorkPool
+
+#endif	/* _WORKPOOL_H */